@@ -68,29 +68,29 @@ int GameController::dealerScore() const
 	return m_game.state().dealer_hand().total();
 }
 
+int GameController::legalMoves() const
+{
+	return m_game.state().legal_moves().mask();
+}
+
 bool GameController::canDeal() const
 {
-	return m_game.state().node() == CardGames::BlackJack::GameNode::Ready;
+	return m_game.state().legal_moves().contains(CardGames::BlackJack::Play::Deal);
 }
 
 bool GameController::canHit() const
 {
-	using enum CardGames::BlackJack::GameNode;
-	auto node = m_game.state().node();
-	return node == PlayersRound || node == PlayersSplitRound;
+	return m_game.state().legal_moves().contains(CardGames::BlackJack::Play::Hit);
 }
 
 bool GameController::canStay() const
 {
-	using enum CardGames::BlackJack::GameNode;
-	auto node = m_game.state().node();
-	return node == PlayersRound || node == PlayersSplitRound;
+	return m_game.state().legal_moves().contains(CardGames::BlackJack::Play::Stay);
 }
 
 bool GameController::canSplit() const
 {
-	return m_game.state().node() == CardGames::BlackJack::GameNode::PlayersRound &&
-				 m_game.state().can_split();
+	return m_game.state().legal_moves().contains(CardGames::BlackJack::Play::Split);
 }
 
 bool GameController::isSplitRound() const
@@ -136,10 +136,8 @@ QVariantList GameController::playerHands() const
 
 bool GameController::isGameOver() const
 {
-	using enum CardGames::BlackJack::GameNode;
-	auto node = m_game.state().node();
-	return node == GameOverPlayerWins || node == GameOverPlayerBusts || node == GameOverDealerWins ||
-				 node == GameOverDealerBusts || node == GameOverDraw;
+	// The dealer's round is played out within next(), so only a finished round accepts no play
+	return m_game.state().legal_moves().empty();
 }
 
 QString GameController::resultMessage() const
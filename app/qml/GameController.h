@@ -19,6 +19,7 @@ class GameController : public QObject
 	Q_PROPERTY(QVariantList dealerHand READ dealerHand NOTIFY handsChanged)
 	Q_PROPERTY(int playerScore READ playerScore NOTIFY handsChanged)
 	Q_PROPERTY(int dealerScore READ dealerScore NOTIFY handsChanged)
+	Q_PROPERTY(int legalMoves READ legalMoves NOTIFY gameStateChanged)
 	Q_PROPERTY(bool canDeal READ canDeal NOTIFY gameStateChanged)
 	Q_PROPERTY(bool canHit READ canHit NOTIFY gameStateChanged)
 	Q_PROPERTY(bool canStay READ canStay NOTIFY gameStateChanged)
@@ -39,6 +40,7 @@ public:
 	QVariantList dealerHand() const;
 	int playerScore() const;
 	int dealerScore() const;
+	int legalMoves() const;
 	bool canDeal() const;
 	bool canHit() const;
 	bool canStay() const;
@@ -42,6 +42,7 @@ TestCase {
         compare(controller.canDeal, true, "Should be able to deal initially")
         compare(controller.canHit, false, "Should not be able to hit initially")
         compare(controller.canStay, false, "Should not be able to stay initially")
+        compare(controller.legalMoves, 1, "Deal should be the only legal move initially")
     }
 
     // Deal action tests
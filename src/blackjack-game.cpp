@@ -1,5 +1,8 @@
 #include "blackjack-game.h"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <numeric>
 #include <span>
 
@@ -7,212 +10,291 @@ namespace CardGames
 {
 	namespace BlackJack
 	{
-		HandValue calculate_hand_value(std::span<const Card> hand)
-		{
-			int total = 0;
-			int ace_count = 0;
-
-			for (const auto& card : hand) {
-				switch (card.rank()) {
-					case Card::Rank::Ace:
-						total += 11;
-						++ace_count;
-						break;
-					case Card::Rank::King:
-					case Card::Rank::Queen:
-					case Card::Rank::Jack: total += 10; break;
-					default: total += static_cast<int>(card.rank()); break;
-				}
+		namespace
+		{
+			/// Node after the split hands change: over if every hand is busted, the dealer's turn
+			/// once every hand is complete, and otherwise the next split hand's turn
+			GameNode split_round_node(const PlayersHand& players_hand)
+			{
+				if (players_hand.all_busted())
+					return GameNode::GameOverPlayerBusts;
+				if (players_hand.all_complete())
+					return GameNode::DealersRound;
+				return GameNode::PlayersSplitRound;
 			}
 
-			// Reduce aces from 11 to 1 as needed to avoid bust
-			int soft_ace_count = ace_count;
-			while (total > 21 && soft_ace_count > 0) {
-				total -= 10;
-				--soft_ace_count;
+			constexpr std::size_t index(GameNode node) { return static_cast<std::size_t>(node); }
+			constexpr std::size_t index(Play play) { return static_cast<std::size_t>(play); }
+
+			/// What a play does, each handled by the BasicGame member of the same name.
+			/// PlayersSplitRound hits and stays move between the split hands, and a split is the
+			/// same whether the player holds one hand or several.
+			enum class Action : std::uint8_t {
+				Ignore,
+				Deal,
+				Hit,
+				Stay,
+				Split,
+				HitSplitHand,
+				StaySplitHand,
+			};
+
+			/// Action of each play, indexed by GameNode then Play. Plays a node doesn't accept are
+			/// ignored, leaving the state as it is.
+			constexpr auto transitions = [] {
+				using enum GameNode;
+				auto table = std::array<std::array<Action, play_count>, game_node_count>{};
+				table[index(Ready)][index(Play::Deal)] = Action::Deal;
+				table[index(PlayersRound)][index(Play::Hit)] = Action::Hit;
+				table[index(PlayersRound)][index(Play::Stay)] = Action::Stay;
+				table[index(PlayersRound)][index(Play::Split)] = Action::Split;
+				table[index(PlayersSplitRound)][index(Play::Hit)] = Action::HitSplitHand;
+				table[index(PlayersSplitRound)][index(Play::Stay)] = Action::StaySplitHand;
+				table[index(PlayersSplitRound)][index(Play::Split)] = Action::Split;
+				return table;
+			}();
+
+			/// The plays the transition table does something with in node
+			constexpr PlaySet accepted_plays(GameNode node)
+			{
+				auto plays = PlaySet{};
+				for (std::size_t play = 0; play < play_count; ++play) {
+					if (transitions[index(node)][play] != Action::Ignore)
+						plays.insert(static_cast<Play>(play));
+				}
+				return plays;
 			}
 
-			return {total, soft_ace_count > 0, soft_ace_count};
-		}
+			// The table accepts exactly the plays of node_plays, which follows the state diagram
+			static_assert([] {
+				for (std::size_t node = 0; node < game_node_count; ++node) {
+					if (accepted_plays(static_cast<GameNode>(node)) != node_plays[node])
+						return false;
+				}
+				return true;
+			}());
+		} // namespace
 
 		int add_em_up(std::span<const Card> hand)
 		{
 			return calculate_hand_value(hand).total;
 		}
 
-		const GameState& Game::next(Game::Play play)
+		template <typename Rules>
+		GameState BasicGame<Rules>::initial_state() const
 		{
-			using enum GameNode;
-			using enum Play;
-
-			const auto& current_state = history.back();
-			switch (current_state.node()) {
-				case Ready:
-					if (play == Deal) {
-						auto deck = current_state.deck();
-						auto player_cards = deck.deal(1);								 // face down
-						auto dealer_cards = deck.deal(1);								 // face down
-						player_cards.emplace_back(deck.deal(1).front()); // face up
-						dealer_cards.emplace_back(deck.deal(1).front()); // face up
-
-						const auto game_node = [&]() {
-							const auto player = add_em_up(player_cards);
-							const auto dealer = add_em_up(dealer_cards);
-							if (player == 21)
-								return GameOverPlayerWins;
-							if (dealer == 21)
-								return GameOverDealerWins;
-							return PlayersRound;
-						}();
-
-						history.emplace_back(game_node, PlayersHand{player_cards}, DealersHand{dealer_cards},
-																 deck);
-						return history.back();
-					}
-					break;
-
-				case PlayersRound:
-					if (play == Hit) {
-						auto deck = current_state.deck();
-						auto players_hand = current_state.players_hand();
-						players_hand.add_to_active(deck.deal(1).front());
-						const auto game_node =
-							players_hand.active_is_busted() ? GameOverPlayerBusts : PlayersRound;
-
-						history.emplace_back(game_node, players_hand, current_state.dealer_hand(), deck);
-						return history.back();
-					} else if (play == Stay) {
-						history.emplace_back(DealersRound, current_state.players_hand(),
-																 current_state.dealer_hand(), current_state.deck());
-						play_dealer_turn();
-						return history.back();
-					} else if (play == Play::Split) {
-						if (current_state.can_split(m_config.allow_resplit_aces)) {
-							auto deck = current_state.deck();
-							auto players_hand = current_state.players_hand();
-							const bool is_aces = players_hand.active_cards()[0].rank() == Card::Rank::Ace;
-
-							players_hand.split(deck.deal(1).front(), deck.deal(1).front());
-
-							if (is_aces) {
-								// Both hands complete immediately - go to dealer
-								history.emplace_back(DealersRound, players_hand, current_state.dealer_hand(), deck);
-								play_dealer_turn();
-							} else {
-								// Start playing hand 0
-								history.emplace_back(PlayersSplitRound, players_hand, current_state.dealer_hand(),
-																		 deck);
-							}
-							return history.back();
-						}
-					}
-					break;
-
-				case PlayersSplitRound:
-					if (play == Hit) {
-						auto deck = current_state.deck();
-						auto players_hand = current_state.players_hand();
-
-						players_hand.add_to_active(deck.deal(1).front());
-
-						if (players_hand.active_is_busted()) {
-							players_hand.mark_active_complete();
-							players_hand.advance_to_next_incomplete();
-						}
-
-						if (players_hand.all_busted()) {
-							history.emplace_back(GameOverPlayerBusts, players_hand, current_state.dealer_hand(),
-																	 deck);
-						} else if (players_hand.all_complete()) {
-							history.emplace_back(DealersRound, players_hand, current_state.dealer_hand(), deck);
-							play_dealer_turn();
-						} else {
-							history.emplace_back(PlayersSplitRound, players_hand, current_state.dealer_hand(),
-																	 deck);
-						}
-						return history.back();
-					} else if (play == Stay) {
-						auto players_hand = current_state.players_hand();
-
-						players_hand.mark_active_complete();
-						players_hand.advance_to_next_incomplete();
-
-						if (players_hand.all_busted()) {
-							history.emplace_back(GameOverPlayerBusts, players_hand, current_state.dealer_hand(),
-																	 current_state.deck());
-						} else if (players_hand.all_complete()) {
-							history.emplace_back(DealersRound, players_hand, current_state.dealer_hand(),
-																	 current_state.deck());
-							play_dealer_turn();
-						} else {
-							history.emplace_back(PlayersSplitRound, players_hand, current_state.dealer_hand(),
-																	 current_state.deck());
-						}
-						return history.back();
-					} else if (play == Play::Split) {
-						if (current_state.can_split(m_config.allow_resplit_aces)) {
-							auto deck = current_state.deck();
-							auto players_hand = current_state.players_hand();
-							const bool is_aces = players_hand.active_cards()[0].rank() == Card::Rank::Ace;
-
-							players_hand.split(deck.deal(1).front(), deck.deal(1).front());
-
-							if (is_aces) {
-								if (players_hand.all_busted()) {
-									history.emplace_back(GameOverPlayerBusts, players_hand,
-																			 current_state.dealer_hand(), deck);
-								} else if (players_hand.all_complete()) {
-									history.emplace_back(DealersRound, players_hand, current_state.dealer_hand(),
-																			 deck);
-									play_dealer_turn();
-								} else {
-									players_hand.advance_to_next_incomplete();
-									history.emplace_back(PlayersSplitRound, players_hand, current_state.dealer_hand(),
-																			 deck);
-								}
-							} else {
-								history.emplace_back(PlayersSplitRound, players_hand, current_state.dealer_hand(),
-																		 deck);
-							}
-							return history.back();
-						}
-					}
-					break;
-
-				case DealersRound:
-					// DealersRound is handled automatically by play_dealer_turn()
-					break;
-
-				case GameOverPlayerBusts:
-				case GameOverPlayerWins:
-				case GameOverDealerBusts:
-				case GameOverDealerWins:
-				case GameOverDraw: break;
+			if (m_config.initial_deck) {
+				return {GameNode::Ready, PlayersHand{}, DealersHand{}, *m_config.initial_deck};
+			}
+			if (m_shoe->needs_reshuffle()) {
+				return GameState{};
+			}
+			return {GameNode::Ready, PlayersHand{}, DealersHand{}, m_shoe->deck()};
+		}
+
+		template <typename Rules>
+		Rng& BasicGame<Rules>::rng()
+		{
+			if (!m_rng) {
+				m_rng = m_config.seed ? Rng{*m_config.seed} : Rng::from_entropy();
+			}
+			return *m_rng;
+		}
+
+		template <typename Rules>
+		const GameState& BasicGame<Rules>::new_round()
+		{
+			// A round that was never dealt leaves the shoe as it found it
+			if (!m_config.initial_deck && state().node() != GameNode::Ready) {
+				m_shoe->update(state().deck());
+			}
+			m_history.clear();
+			m_history.push_back(initial_state());
+			return m_history.back();
+		}
+
+		template <typename Rules>
+		Shoe BasicGame<Rules>::shoe() const
+		{
+			if (m_config.initial_deck) {
+				return m_shoe ? *m_shoe : Shoe{m_config.shoe};
+			}
+			auto shoe = *m_shoe;
+			if (state().node() != GameNode::Ready) {
+				shoe.update(state().deck());
+			}
+			return shoe;
+		}
+
+		template <typename Rules>
+		Deck BasicGame<Rules>::take_deck()
+		{
+			if (m_history.replaces_back())
+				return std::move(m_history.back()).deck();
+			return m_history.back().deck();
+		}
+
+		template <typename Rules>
+		Deck BasicGame<Rules>::deck_to_deal()
+		{
+			if (m_config.initial_deck || !m_shoe->needs_reshuffle())
+				return take_deck();
+			m_shoe->shuffle(rng());
+			return m_shoe->deck();
+		}
+
+		template <typename Rules>
+		const GameState& BasicGame<Rules>::next(Play play)
+		{
+			const auto& current_state = m_history.back();
+			switch (transitions[index(current_state.node())][index(play)]) {
+				case Action::Ignore: break;
+				case Action::Deal: return deal();
+				case Action::Hit: return hit(current_state);
+				case Action::Stay: return stay(current_state);
+				case Action::Split: return split(current_state);
+				case Action::HitSplitHand: return hit_split_hand(current_state);
+				case Action::StaySplitHand: return stay_split_hand(current_state);
 			}
 			return current_state;
 		}
 
-		void Game::play_dealer_turn()
+		// Each handler takes one working copy of the deck and hands, deals from it and moves it
+		// into the new state
+
+		template <typename Rules>
+		const GameState& BasicGame<Rules>::deal()
 		{
 			using enum GameNode;
 
-			while (history.back().node() == DealersRound) {
-				const auto& current_state = history.back();
+			auto deck = deck_to_deal();
+			auto players_hand = PlayersHand{};
+			auto dealers_hand = DealersHand{};
+			players_hand.add_to_active(deck.deal()); // face down
+			dealers_hand.add(deck.deal());					 // face down
+			players_hand.add_to_active(deck.deal()); // face up
+			dealers_hand.add(deck.deal());					 // face up
+
+			const auto game_node = [&]() {
+				if (players_hand.active_total() == 21)
+					return GameOverPlayerWins;
+				if (dealers_hand.total() == 21)
+					return GameOverDealerWins;
+				return PlayersRound;
+			}();
+
+			return push_state(game_node, std::move(players_hand), std::move(dealers_hand),
+												std::move(deck));
+		}
+
+		template <typename Rules>
+		const GameState& BasicGame<Rules>::hit(const GameState& current_state)
+		{
+			auto deck = take_deck();
+			auto players_hand = current_state.players_hand();
+			players_hand.add_to_active(deck.deal());
+			const auto game_node =
+				players_hand.active_is_busted() ? GameNode::GameOverPlayerBusts : GameNode::PlayersRound;
+
+			return push_state(game_node, std::move(players_hand), current_state.dealer_hand(),
+												std::move(deck));
+		}
+
+		template <typename Rules>
+		const GameState& BasicGame<Rules>::stay(const GameState& current_state)
+		{
+			return push_state(GameNode::DealersRound, current_state.players_hand(),
+												current_state.dealer_hand(), take_deck());
+		}
+
+		template <typename Rules>
+		const GameState& BasicGame<Rules>::split(const GameState& current_state)
+		{
+			if (!current_state.legal_moves().contains(Play::Split))
+				return current_state;
+
+			auto deck = take_deck();
+			auto players_hand = current_state.players_hand();
+			const bool is_aces = players_hand.active_cards()[0].rank() == Card::Rank::Ace;
+
+			const auto first_new_card = deck.deal();
+			const auto second_new_card = deck.deal();
+			players_hand.split(first_new_card, second_new_card);
+
+			// Split aces are complete at once: the dealer's turn if no other hand is left, and
+			// otherwise the next incomplete hand's
+			const auto game_node = is_aces ? split_round_node(players_hand) : GameNode::PlayersSplitRound;
+			if (is_aces && game_node == GameNode::PlayersSplitRound)
+				players_hand.advance_to_next_incomplete();
+
+			return push_state(game_node, std::move(players_hand), current_state.dealer_hand(),
+												std::move(deck));
+		}
+
+		template <typename Rules>
+		const GameState& BasicGame<Rules>::hit_split_hand(const GameState& current_state)
+		{
+			auto deck = take_deck();
+			auto players_hand = current_state.players_hand();
+
+			players_hand.add_to_active(deck.deal());
+
+			if (players_hand.active_is_busted()) {
+				players_hand.mark_active_complete();
+				players_hand.advance_to_next_incomplete();
+			}
+
+			return push_state(split_round_node(players_hand), std::move(players_hand),
+												current_state.dealer_hand(), std::move(deck));
+		}
+
+		template <typename Rules>
+		const GameState& BasicGame<Rules>::stay_split_hand(const GameState& current_state)
+		{
+			auto players_hand = current_state.players_hand();
+
+			players_hand.mark_active_complete();
+			players_hand.advance_to_next_incomplete();
+
+			return push_state(split_round_node(players_hand), std::move(players_hand),
+												current_state.dealer_hand(), take_deck());
+		}
+
+		template <typename Rules>
+		template <typename... Args>
+		const GameState& BasicGame<Rules>::push_state(Args&&... args)
+		{
+			const auto& state =
+				m_history.emplace_back(std::forward<Args>(args)..., m_rules.allow_resplit_aces);
+			if (state.node() != GameNode::DealersRound)
+				return state;
+			play_dealer_turn();
+			return m_history.back();
+		}
+
+		template <typename Rules>
+		void BasicGame<Rules>::play_dealer_turn()
+		{
+			using enum GameNode;
+
+			while (m_history.back().node() == DealersRound) {
+				const auto& current_state = m_history.back();
 				const auto& dealer = current_state.dealer_hand();
 				const auto hand_value = dealer.value();
 
 				const bool must_hit = hand_value.total < 17 || (hand_value.total == 17 &&
-																												hand_value.is_soft && m_config.hit_soft_17);
+																												hand_value.is_soft && m_rules.hit_soft_17);
 
 				if (must_hit) {
-					auto deck = current_state.deck();
+					auto deck = take_deck();
 					auto dealers_hand = dealer;
-					dealers_hand.add(deck.deal(1).front());
+					dealers_hand.add(deck.deal());
 
 					const auto new_value = dealers_hand.value();
 					const auto game_node = (new_value.total > 21) ? GameOverDealerBusts : DealersRound;
 
-					history.emplace_back(game_node, current_state.players_hand(), dealers_hand, deck);
+					m_history.emplace_back(game_node, current_state.players_hand(), std::move(dealers_hand),
+																 std::move(deck));
 				} else {
 					const auto player_total = current_state.players_hand().active_total();
 					const auto dealer_total = hand_value.total;
@@ -224,10 +306,16 @@ namespace CardGames
 						else
 							return GameOverDraw;
 					}();
-					history.emplace_back(game_node, current_state.players_hand(), current_state.dealer_hand(),
-															 current_state.deck());
+					m_history.emplace_back(game_node, current_state.players_hand(),
+																 current_state.dealer_hand(), take_deck());
 				}
 			}
 		}
+
+		template class BasicGame<ConfiguredRules>;
+		template class BasicGame<FixedRules<false, false>>;
+		template class BasicGame<FixedRules<false, true>>;
+		template class BasicGame<FixedRules<true, false>>;
+		template class BasicGame<FixedRules<true, true>>;
 	} // namespace BlackJack
 } // namespace CardGames
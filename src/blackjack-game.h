@@ -1,11 +1,19 @@
 #pragma once
 
 #include "deck.h"
+#include "history.h"
+#include "inline-vector.h"
+#include "shoe.h"
 
 #include <algorithm>
+#include <array>
+#include <cassert>
 #include <concepts>
+#include <cstdint>
+#include <initializer_list>
 #include <optional>
 #include <span>
+#include <type_traits>
 
 namespace CardGames
 {
@@ -13,61 +21,166 @@ namespace CardGames
 	{
 		/// Result of calculating a hand's blackjack value
 		struct HandValue {
-			int total;					///< Final calculated total (soft aces adjusted)
-			bool is_soft;				///< True if an Ace is currently counted as 11
-			int soft_ace_count; ///< Number of Aces counted as 11
+			int total = 0;					///< Final calculated total (soft aces adjusted)
+			bool is_soft = false;		///< True if an Ace is currently counted as 11
+			int soft_ace_count = 0; ///< Number of Aces counted as 11
 
 			bool operator==(const HandValue&) const = default;
 		};
 
+		namespace detail
+		{
+			/// Each rank's entry packs its points, with aces counted as 1, in the low bits and
+			/// its ace count in the bits from ace_shift up, so a hand is summed one add per card
+			inline constexpr unsigned ace_shift = 16;
+			inline constexpr unsigned hard_mask = (1u << ace_shift) - 1;
+
+			/// Indexed by the rank's value
+			inline constexpr auto rank_points = [] {
+				auto points = std::array<unsigned, static_cast<int>(Card::Rank::Ace) + 1>{};
+				for (unsigned rank = 2; rank <= 10; ++rank)
+					points[rank] = rank;
+				points[static_cast<int>(Card::Rank::Jack)] = 10;
+				points[static_cast<int>(Card::Rank::Queen)] = 10;
+				points[static_cast<int>(Card::Rank::King)] = 10;
+				points[static_cast<int>(Card::Rank::Ace)] = 1 | (1u << ace_shift);
+				return points;
+			}();
+
+			/// Highest hard total at which an ace can still count as 11. Two aces can never both
+			/// count as 11, so a hand has at most one soft ace.
+			inline constexpr int max_soft_total = 11;
+
+			/// Points added by a soft ace, indexed by the hand's hard total, capped at
+			/// max_soft_total + 1, and by whether the hand holds an ace
+			inline constexpr auto soft_points = [] {
+				auto points = std::array<std::array<int, 2>, max_soft_total + 2>{};
+				for (int hard_total = 0; hard_total <= max_soft_total; ++hard_total)
+					points[hard_total][1] = 10;
+				return points;
+			}();
+
+			static_assert(rank_points[static_cast<int>(Card::Rank::Ten)] == 10);
+			static_assert(rank_points[static_cast<int>(Card::Rank::King)] == 10);
+			static_assert((rank_points[static_cast<int>(Card::Rank::Ace)] & hard_mask) == 1);
+			static_assert(soft_points[11][1] == 10 && soft_points[12][1] == 0);
+			static_assert(soft_points[0][0] == 0);
+
+			constexpr unsigned points_of(const Card& card)
+			{
+				return rank_points[static_cast<int>(card.rank())];
+			}
+
+			constexpr HandValue hand_value(int hard_total, bool has_ace)
+			{
+				const auto soft = soft_points[std::min(hard_total, max_soft_total + 1)][has_ace];
+				return {hard_total + soft, soft != 0, soft / 10};
+			}
+		} // namespace detail
+
 		/// Calculate hand value with soft ace logic
 		/// Aces count as 11 unless that would cause a bust, then they count as 1
-		HandValue calculate_hand_value(std::span<const Card> hand);
+		constexpr HandValue calculate_hand_value(std::span<const Card> hand)
+		{
+			auto points = 0u;
+			for (const auto& card : hand)
+				points += detail::points_of(card);
+			return detail::hand_value(static_cast<int>(points & detail::hard_mask),
+																(points >> detail::ace_shift) != 0);
+		}
+
+		/// Value of a hand after adding card to a hand worth value. Gives the same result as
+		/// calculate_hand_value() over all the cards, in constant time.
+		constexpr HandValue add_card(HandValue value, const Card& card)
+		{
+			// A hand with no soft ace either holds no ace or is past max_soft_total, where an ace
+			// makes no difference
+			const auto points = detail::points_of(card);
+			const auto hard_total =
+				value.total - 10 * value.soft_ace_count + static_cast<int>(points & detail::hard_mask);
+			return detail::hand_value(hard_total,
+																value.soft_ace_count > 0 || (points >> detail::ace_shift) != 0);
+		}
+
+		/// Most cards a hand can hold. A hand of 21 cards is worth at least 21, so one more card
+		/// ends it at 22 cards whatever the number of decks.
+		inline constexpr std::size_t max_hand_cards = 22;
+
+		/// Cards of one hand, held inline so hands never allocate
+		using HandCards = InlineVector<Card, max_hand_cards>;
 
 		/// Dealer's hand - simple container, no split logic
 		class DealersHand
 		{
 		public:
 			DealersHand() = default;
-			explicit DealersHand(const std::vector<Card>& cards)
+
+			/// A hand of cards, of which there must be at most max_hand_cards
+			explicit DealersHand(std::span<const Card> cards)
 				: m_cards{cards}
+				, m_value{calculate_hand_value(cards)}
 			{
 			}
 
-			const std::vector<Card>& cards() const { return m_cards; }
-			void add(const Card& card) { m_cards.push_back(card); }
+			std::span<const Card> cards() const { return m_cards; }
+			void add(const Card& card)
+			{
+				m_cards.push_back(card);
+				m_value = add_card(m_value, card);
+			}
 
-			HandValue value() const { return calculate_hand_value(m_cards); }
-			int total() const { return value().total; }
-			bool is_soft() const { return value().is_soft; }
+			const HandValue& value() const { return m_value; }
+			int total() const { return m_value.total; }
+			bool is_soft() const { return m_value.is_soft; }
 
 			bool operator==(const DealersHand&) const = default;
 
 		private:
-			std::vector<Card> m_cards;
+			HandCards m_cards;
+			HandValue m_value; ///< Kept up to date as cards are added
 		};
 
+		static_assert(std::is_trivially_copyable_v<DealersHand>);
+
 		/// Player's hand container managing multiple hands (for splits)
 		class PlayersHand
 		{
 		public:
 			struct SingleHand {
-				std::vector<Card> cards;
+				HandCards cards;
 				bool is_from_split = false;
 				bool is_from_split_aces = false;
 				bool is_complete = false;
 				int split_count = 0;
+				HandValue value = {}; ///< Value of cards, kept up to date by PlayersHand
 
 				bool operator==(const SingleHand&) const = default;
 			};
 
+			static_assert(std::is_trivially_copyable_v<SingleHand>);
+
+			/// Most hands a player can hold: three splits, each adding a hand
+			static constexpr std::size_t max_hands = 4;
+
 			PlayersHand() = default;
-			explicit PlayersHand(const std::vector<Card>& cards) { m_hands[0].cards = cards; }
+
+			/// A single hand of cards, of which there must be at most max_hand_cards
+			explicit PlayersHand(std::span<const Card> cards)
+			{
+				m_hands[0].cards = HandCards{cards};
+				m_hands[0].value = calculate_hand_value(cards);
+			}
 
 			// Active hand operations
-			const std::vector<Card>& active_cards() const { return m_hands[m_active_index].cards; }
-			void add_to_active(const Card& card) { m_hands[m_active_index].cards.push_back(card); }
-			int active_total() const { return calculate_hand_value(active_cards()).total; }
+			std::span<const Card> active_cards() const { return m_hands[m_active_index].cards; }
+			void add_to_active(const Card& card)
+			{
+				auto& hand = m_hands[m_active_index];
+				hand.cards.push_back(card);
+				hand.value = add_card(hand.value, card);
+			}
+			const HandValue& active_value() const { return m_hands[m_active_index].value; }
+			int active_total() const { return active_value().total; }
 			bool active_is_busted() const { return active_total() > 21; }
 
 			// Split operations
@@ -75,7 +188,8 @@ namespace CardGames
 			{
 				const auto& hand = m_hands[m_active_index];
 				return hand.cards.size() == 2 && hand.cards[0].rank() == hand.cards[1].rank() &&
-							 (allow_resplit_aces || !hand.is_from_split_aces) && hand.split_count < 3;
+							 (allow_resplit_aces || !hand.is_from_split_aces) && hand.split_count < 3 &&
+							 m_hands.size() < max_hands;
 			}
 
 			void split(const Card& first_new_card, const Card& second_new_card)
@@ -87,6 +201,7 @@ namespace CardGames
 				// Create second hand from split
 				SingleHand second_hand;
 				second_hand.cards = {current.cards[1], second_new_card};
+				second_hand.value = calculate_hand_value(second_hand.cards);
 				second_hand.is_from_split = true;
 				second_hand.is_from_split_aces = is_aces;
 				second_hand.is_complete = is_aces;
@@ -94,13 +209,14 @@ namespace CardGames
 
 				// Update current hand
 				current.cards = {current.cards[0], first_new_card};
+				current.value = calculate_hand_value(current.cards);
 				current.is_from_split = true;
 				current.is_from_split_aces = is_aces;
 				current.is_complete = is_aces;
 				current.split_count = new_split_count;
 
 				// Insert second hand after current
-				m_hands.insert(m_hands.begin() + static_cast<long>(m_active_index) + 1, second_hand);
+				m_hands.insert(m_hands.begin() + m_active_index + 1, second_hand);
 			}
 
 			// Completion tracking
@@ -125,22 +241,28 @@ namespace CardGames
 			bool all_busted() const
 			{
 				return std::ranges::all_of(m_hands, [](const SingleHand& h) {
-					return h.is_complete && calculate_hand_value(h.cards).total > 21;
+					return h.is_complete && h.value.total > 21;
 				});
 			}
 
 			// Multi-hand queries
 			size_t hand_count() const { return m_hands.size(); }
 			size_t active_index() const { return m_active_index; }
-			const std::vector<SingleHand>& all_hands() const { return m_hands; }
+			std::span<const SingleHand> all_hands() const { return m_hands; }
 
 			bool operator==(const PlayersHand&) const = default;
 
 		private:
-			std::vector<SingleHand> m_hands = {SingleHand{}};
+			/// Hands in play order, split hands stored inline; there is always at least one
+			InlineVector<SingleHand, max_hands> m_hands = {SingleHand{}};
 			size_t m_active_index = 0;
 		};
 
+		static_assert(std::is_trivially_copyable_v<PlayersHand>);
+
+		/// The shoe's reserve counts on four hands at most
+		static_assert(max_round_points >= PlayersHand::max_hands * 31 + 26);
+
 		enum class GameNode {
 			Ready,
 			PlayersRound,
@@ -153,22 +275,105 @@ namespace CardGames
 			GameOverDraw,
 		};
 
+		enum class Play { Deal, Hit, Stay, Split };
+
+		/// Number of Play enumerators
+		inline constexpr std::size_t play_count = static_cast<std::size_t>(Play::Split) + 1;
+
+		/// Number of GameNode enumerators, for tables indexed by node
+		inline constexpr std::size_t game_node_count =
+			static_cast<std::size_t>(GameNode::GameOverDraw) + 1;
+
+		/// Set of plays, one bit per Play
+		class PlaySet
+		{
+		public:
+			constexpr PlaySet() = default;
+
+			constexpr PlaySet(std::initializer_list<Play> plays)
+			{
+				for (const auto play : plays)
+					insert(play);
+			}
+
+			constexpr std::uint8_t mask() const { return m_mask; }
+			constexpr bool empty() const { return m_mask == 0; }
+			constexpr bool contains(Play play) const { return (m_mask & bit(play)) != 0; }
+
+			constexpr void insert(Play play) { m_mask |= bit(play); }
+			constexpr void erase(Play play) { m_mask &= static_cast<std::uint8_t>(~bit(play)); }
+
+			constexpr PlaySet operator|(PlaySet other) const
+			{
+				auto set = *this;
+				set.m_mask |= other.m_mask;
+				return set;
+			}
+
+			constexpr bool operator==(const PlaySet&) const = default;
+
+		private:
+			static constexpr std::uint8_t bit(Play play)
+			{
+				return static_cast<std::uint8_t>(1u << static_cast<unsigned>(play));
+			}
+
+			std::uint8_t m_mask = 0;
+		};
+
+		static_assert(std::regular<PlaySet>);
+
+		/// Plays each node accepts, indexed by GameNode, as drawn in docs/design/game-logic.md.
+		/// Split is accepted only when GameState::can_split() allows it too.
+		inline constexpr auto node_plays = std::array<PlaySet, game_node_count>{
+			PlaySet{Play::Deal},												 // Ready
+			PlaySet{Play::Hit, Play::Stay, Play::Split}, // PlayersRound
+			PlaySet{Play::Hit, Play::Stay, Play::Split}, // PlayersSplitRound
+			PlaySet{},																	 // DealersRound, played automatically
+			PlaySet{},																	 // GameOverPlayerBusts
+			PlaySet{},																	 // GameOverPlayerWins
+			PlaySet{},																	 // GameOverDealerBusts
+			PlaySet{},																	 // GameOverDealerWins
+			PlaySet{},																	 // GameOverDraw
+		};
+
 		struct GameState {
 		public:
+			/// Ready state with an empty deck. It neither allocates nor shuffles; a state that is to
+			/// be dealt from is given its deck, or built from an Rng.
 			GameState() = default;
 
-			GameState(GameNode node, PlayersHand players_hand, DealersHand dealers_hand, Deck deck)
+			/// Ready state with a full deck shuffled by rng
+			explicit GameState(Rng& rng)
+				: m_deck{shuffle(Deck{}, rng)}
+			{
+			}
+
+			/// A state whose legal_moves() are those of node, less Split if the player's active hand
+			/// can't be split under allow_resplit_aces
+			GameState(GameNode node, PlayersHand players_hand, DealersHand dealers_hand, Deck deck,
+								bool allow_resplit_aces = false)
 				: m_node{node}
+				, m_legal_moves{node_plays[static_cast<std::size_t>(node)]}
 				, m_players_hand{std::move(players_hand)}
 				, m_dealers_hand{std::move(dealers_hand)}
 				, m_deck{std::move(deck)}
 			{
+				if (m_legal_moves.contains(Play::Split) && !m_players_hand.can_split(allow_resplit_aces))
+					m_legal_moves.erase(Play::Split);
 			}
 
 			GameNode node() const { return m_node; }
+
+			/// The plays next() accepts in this state, worked out once when the state is built
+			PlaySet legal_moves() const { return m_legal_moves; }
+
 			const PlayersHand& players_hand() const { return m_players_hand; }
 			const DealersHand& dealer_hand() const { return m_dealers_hand; }
-			const Deck& deck() const { return m_deck; }
+			const Deck& deck() const& { return m_deck; }
+
+			/// The deck moved out of a state that is about to be replaced
+			Deck deck() && { return std::move(m_deck); }
 
 			bool can_split(bool allow_resplit_aces = false) const
 			{
@@ -179,9 +384,10 @@ namespace CardGames
 
 		private:
 			GameNode m_node = GameNode::Ready;
+			PlaySet m_legal_moves = {Play::Deal};
 			PlayersHand m_players_hand;
 			DealersHand m_dealers_hand;
-			Deck m_deck = {shuffle(Deck{})};
+			Deck m_deck = Deck{std::vector<Card>{}};
 		};
 
 		static_assert(std::regular<GameState>);
@@ -191,34 +397,155 @@ namespace CardGames
 			bool hit_soft_17 = true;				 ///< If true, dealer hits on soft 17 (standard casino rule)
 			bool allow_resplit_aces = false; ///< If true, player can resplit aces (RSA); default is NRSA
 			std::optional<Deck> initial_deck = std::nullopt; ///< For deterministic testing
+			std::optional<std::uint64_t> seed = std::nullopt; ///< Shuffle seed; random if unset
+			ShoeConfig shoe = {}; ///< Defaults to a single deck shuffled every round
+			HistoryConfig history = {}; ///< Defaults to keeping every state of the round
+		};
+
+		/// Table rules read from a BlackjackConfig when the game is built
+		struct ConfiguredRules {
+			bool hit_soft_17 = true;
+			bool allow_resplit_aces = false;
+
+			ConfiguredRules() = default;
+
+			explicit ConfiguredRules(const BlackjackConfig& config)
+				: hit_soft_17{config.hit_soft_17}
+				, allow_resplit_aces{config.allow_resplit_aces}
+			{
+			}
 		};
 
-		class Game
+		/// Table rules fixed at compile time. A game with them tests constants, so the rule
+		/// branches fold away. The rule fields of its BlackjackConfig must match them, which
+		/// apply() ensures and debug builds assert.
+		template <bool HitSoft17, bool AllowResplitAces>
+		struct FixedRules {
+			static constexpr bool hit_soft_17 = HitSoft17;
+			static constexpr bool allow_resplit_aces = AllowResplitAces;
+
+			FixedRules() = default;
+
+			explicit constexpr FixedRules([[maybe_unused]] const BlackjackConfig& config)
+			{
+				assert(config.hit_soft_17 == hit_soft_17 &&
+							 config.allow_resplit_aces == allow_resplit_aces);
+			}
+
+			/// config with its rule fields set to these rules
+			static BlackjackConfig apply(BlackjackConfig config)
+			{
+				config.hit_soft_17 = hit_soft_17;
+				config.allow_resplit_aces = allow_resplit_aces;
+				return config;
+			}
+		};
+
+		/// A game of blackjack played under Rules, which supplies hit_soft_17 and
+		/// allow_resplit_aces and is built from the game's BlackjackConfig. It is instantiated for
+		/// ConfiguredRules, which is Game, and for every FixedRules.
+		template <typename Rules>
+		class BasicGame
 		{
 		public:
-			enum class Play { Deal, Hit, Stay, Split };
+			using Play = BlackJack::Play;
 
-			explicit Game(BlackjackConfig config = {})
+			/// A game ready to deal from a new shoe, or from initial_deck, in which case no shoe is
+			/// built. Nothing is shuffled until the first Deal.
+			explicit BasicGame(BlackjackConfig config = {})
 				: m_config{config}
-				, history{config.initial_deck
-										? std::vector<GameState>{GameState{GameNode::Ready, PlayersHand{},
-																											 DealersHand{}, *config.initial_deck}}
-										: std::vector<GameState>{GameState{}}}
+				, m_rules{config}
+				, m_history{config.history}
 			{
+				if (!m_config.initial_deck) {
+					m_shoe.emplace(m_config.shoe);
+				}
+				m_history.push_back(initial_state());
+			}
+
+			/// Continues dealing from an existing shoe, shuffling it at the first Deal if it needs it
+			BasicGame(BlackjackConfig config, Shoe shoe)
+				: m_config{config}
+				, m_rules{config}
+				, m_shoe{std::move(shoe)}
+				, m_history{config.history}
+			{
+				m_history.push_back(initial_state());
 			}
 
 			const GameState& next(Play play);
-			const GameState& state() const { return history.back(); }
+			const GameState& state() const { return m_history.back(); }
+
+			/// The states of the current round retained under the configured HistoryRetention,
+			/// oldest first and ending with state()
+			const History<GameState>& history() const { return m_history; }
+
+			/// Starts the next round with the cards left in the shoe, which is reshuffled when the
+			/// round is dealt if its policy requires; a game with an initial_deck deals every round
+			/// from that deck instead.
+			/// Abandons the current round if it isn't over. The history is cleared but keeps its
+			/// storage, so a session of rounds doesn't reallocate it.
+			const GameState& new_round();
+
+			/// The shoe with the cards remaining in the current state. Before a round is dealt it is
+			/// the shoe as the round found it, not yet reshuffled. A game dealing from an initial_deck
+			/// never deals from a shoe, so it gets the one it was given or a new unshuffled one.
+			Shoe shoe() const;
+
+			const Rules& rules() const { return m_rules; }
 
 		private:
+			/// Ready state dealing from initial_deck, or else from the shoe. While the shoe needs
+			/// reshuffling it holds no deck, since deal() shuffles the shoe and deals from that.
+			GameState initial_state() const;
+
+			/// The shuffling engine, seeded on first use from the configured seed or else from
+			/// std::random_device, so a game that is never dealt, deals from an initial_deck or
+			/// continues a shuffled shoe never reads the entropy source
+			Rng& rng();
+
+			/// The current state's deck, for the next state to deal from. It is moved out when the
+			/// next state replaces the current one in the history, and copied otherwise.
+			Deck take_deck();
+
+			/// The deck the round is dealt from: the current state's, unless the shoe needs
+			/// reshuffling, in which case it is shuffled first and its deck copied
+			Deck deck_to_deal();
+
+			/// Handlers of the actions in the transition table. Each deals from current_state's deck
+			/// and appends the states the play leads to; a refused split appends nothing.
+			const GameState& deal();
+			const GameState& hit(const GameState& current_state);
+			const GameState& stay(const GameState& current_state);
+			const GameState& split(const GameState& current_state);
+			const GameState& hit_split_hand(const GameState& current_state);
+			const GameState& stay_split_hand(const GameState& current_state);
+
+			/// Appends the state built from args under the game's rules, then plays the dealer's turn
+			/// if it is the dealer's round
+			template <typename... Args>
+			const GameState& push_state(Args&&... args);
+
 			/// Plays the dealer's turn automatically according to game rules
-			/// Called after player stays; appends states to history until game over
+			/// Called after player stays; appends states to the history until game over
 			void play_dealer_turn();
 
 			BlackjackConfig m_config;
-			std::vector<GameState> history;
+			Rules m_rules;
+			std::optional<Rng> m_rng;
+			std::optional<Shoe> m_shoe; ///< Not built for a game dealing from initial_deck
+			History<GameState> m_history;
 		};
 
+		extern template class BasicGame<ConfiguredRules>;
+		extern template class BasicGame<FixedRules<false, false>>;
+		extern template class BasicGame<FixedRules<false, true>>;
+		extern template class BasicGame<FixedRules<true, false>>;
+		extern template class BasicGame<FixedRules<true, true>>;
+
+		/// Game with the rules given in its BlackjackConfig
+		using Game = BasicGame<ConfiguredRules>;
+
 		int add_em_up(std::span<const Card> hand);
 
 	} // namespace BlackJack
@@ -0,0 +1,126 @@
+#include "simulation.h"
+
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace
+{
+	void print_usage()
+	{
+		std::cerr << "Usage: blackjack-sim [--rounds N] [--strategy NAME] [--threads N] [--seed N]\n"
+							<< "                     [--decks N] [--penetration F] [--stand-soft-17]\n"
+							<< "N >= 1 decks; penetration F in (0, 1]\n"
+							<< "Strategies: ";
+		for (const auto& n : CardGames::BlackJack::get_strategy_names()) {
+			std::cerr << n << " ";
+		}
+		std::cerr << "\n";
+	}
+
+	/// The whole of text as a number, or nothing if it isn't one
+	template <typename T>
+	std::optional<T> parse(std::string_view text)
+	{
+		auto value = T{};
+		const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+		if (error != std::errc{} || end != text.data() + text.size())
+			return std::nullopt;
+		return value;
+	}
+
+	void print_result(const CardGames::BlackJack::SimulationResult& result, double seconds)
+	{
+		using namespace CardGames::BlackJack;
+
+		std::cout << "Rounds:        " << result.rounds << "\n";
+		std::cout << "Elapsed:       " << std::fixed << std::setprecision(3) << seconds << " s\n";
+		std::cout << "Rounds/second: " << std::fixed << std::setprecision(0)
+							<< (seconds > 0 ? static_cast<double>(result.rounds) / seconds : 0.0) << "\n\n";
+
+		for (std::size_t i = 0; i < game_node_count; ++i) {
+			const auto count = result.outcomes[i];
+			if (count == 0)
+				continue;
+			const auto share = 100.0 * static_cast<double>(count) / static_cast<double>(result.rounds);
+			std::cout << std::left << std::setw(22) << game_node_name(static_cast<GameNode>(i))
+								<< std::right << std::setw(14) << count << "  " << std::fixed
+								<< std::setprecision(3) << std::setw(7) << share << " %\n";
+		}
+	}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	using namespace CardGames::BlackJack;
+
+	std::uint64_t rounds = 1'000'000;
+	std::string strategy_name = "basic";
+	auto config = BlackjackConfig{};
+	auto options = SimulationOptions{.seed = std::random_device{}()};
+
+	for (int i = 1; i < argc; ++i) {
+		const auto arg = std::string_view(argv[i]);
+		const auto has_value = i + 1 < argc;
+		auto valid = true;
+		if (arg == "--rounds" && has_value) {
+			const auto value = parse<std::uint64_t>(argv[++i]);
+			valid = value.has_value();
+			rounds = value.value_or(0);
+		} else if (arg == "--strategy" && has_value) {
+			strategy_name = argv[++i];
+		} else if (arg == "--threads" && has_value) {
+			const auto value = parse<unsigned>(argv[++i]);
+			valid = value.has_value();
+			options.threads = value.value_or(0);
+		} else if (arg == "--seed" && has_value) {
+			const auto value = parse<std::uint64_t>(argv[++i]);
+			valid = value.has_value();
+			options.seed = value.value_or(0);
+		} else if (arg == "--decks" && has_value) {
+			// A shoe needs at least one deck to deal from
+			const auto value = parse<std::size_t>(argv[++i]);
+			valid = value.has_value() && *value >= 1;
+			config.shoe.decks = value.value_or(1);
+			config.shoe.reshuffle = ReshufflePolicy::CutCard;
+		} else if (arg == "--penetration" && has_value) {
+			const auto value = parse<double>(argv[++i]);
+			valid = value.has_value() && *value > 0.0 && *value <= 1.0;
+			config.shoe.penetration = value.value_or(1.0);
+		} else if (arg == "--stand-soft-17") {
+			config.hit_soft_17 = false;
+		} else {
+			print_usage();
+			return 1;
+		}
+
+		if (!valid) {
+			std::cerr << "Invalid value for " << arg << ": " << argv[i] << "\n";
+			print_usage();
+			return 1;
+		}
+	}
+
+	const auto strategy = get_strategy(strategy_name);
+	if (!strategy) {
+		std::cerr << "Unknown strategy: " << strategy_name << "\n";
+		print_usage();
+		return 1;
+	}
+
+	std::cout << "Seed:          " << options.seed << "\n";
+
+	const auto start = std::chrono::steady_clock::now();
+	const auto result = simulate(rounds, *strategy, config, options);
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+	print_result(result, elapsed.count());
+	return 0;
+}
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "card.h"
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <span>
+#include <vector>
+
+/// Set of distinct cards held in a 64-bit mask. Card (suit, rank) is bit suit * 16 + rank, so
+/// each suit takes 16 bits with its ranks at bits 2 to 14. Membership, counting and set
+/// algebra are each a few instructions.
+class CardSet
+{
+	using Rank = Card::Rank;
+	using Suit = Card::Suit;
+
+public:
+	constexpr CardSet() = default;
+
+	constexpr CardSet(std::initializer_list<Card> cards)
+	{
+		for (const auto& card : cards)
+			insert(card);
+	}
+
+	/// The distinct cards in cards; duplicates are held once
+	explicit constexpr CardSet(std::span<const Card> cards)
+	{
+		for (const auto& card : cards)
+			insert(card);
+	}
+
+	/// The set with exactly the bits of mask
+	static constexpr CardSet from_mask(std::uint64_t mask)
+	{
+		auto set = CardSet{};
+		set.m_mask = mask;
+		return set;
+	}
+
+	/// All 52 cards
+	static constexpr CardSet full_deck() { return from_mask(ranks_of_suit * suit_repeat); }
+
+	/// The four cards of a rank
+	static constexpr CardSet of_rank(Rank rank)
+	{
+		return from_mask(suit_repeat << static_cast<unsigned>(rank));
+	}
+
+	/// The thirteen cards of a suit
+	static constexpr CardSet of_suit(Suit suit)
+	{
+		return from_mask(ranks_of_suit << (static_cast<unsigned>(suit) * bits_per_suit));
+	}
+
+	constexpr std::uint64_t mask() const { return m_mask; }
+	constexpr std::size_t size() const { return static_cast<std::size_t>(std::popcount(m_mask)); }
+	constexpr bool empty() const { return m_mask == 0; }
+
+	constexpr bool contains(const Card& card) const { return (m_mask & bit(card)) != 0; }
+
+	/// Adds card; returns false if it was already in the set
+	constexpr bool insert(const Card& card)
+	{
+		const auto inserted = !contains(card);
+		m_mask |= bit(card);
+		return inserted;
+	}
+
+	/// Removes card; returns false if it was not in the set
+	constexpr bool erase(const Card& card)
+	{
+		const auto erased = contains(card);
+		m_mask &= ~bit(card);
+		return erased;
+	}
+
+	constexpr CardSet& operator|=(CardSet other)
+	{
+		m_mask |= other.m_mask;
+		return *this;
+	}
+
+	constexpr CardSet& operator&=(CardSet other)
+	{
+		m_mask &= other.m_mask;
+		return *this;
+	}
+
+	/// Removes the cards of other
+	constexpr CardSet& operator-=(CardSet other)
+	{
+		m_mask &= ~other.m_mask;
+		return *this;
+	}
+
+	constexpr CardSet& operator^=(CardSet other)
+	{
+		m_mask ^= other.m_mask;
+		return *this;
+	}
+
+	friend constexpr CardSet operator|(CardSet a, CardSet b) { return a |= b; }
+	friend constexpr CardSet operator&(CardSet a, CardSet b) { return a &= b; }
+	friend constexpr CardSet operator-(CardSet a, CardSet b) { return a -= b; }
+	friend constexpr CardSet operator^(CardSet a, CardSet b) { return a ^= b; }
+
+	/// True if every card of this set is in other
+	constexpr bool is_subset_of(CardSet other) const { return (m_mask & ~other.m_mask) == 0; }
+
+	constexpr bool operator==(const CardSet&) const = default;
+
+	/// Visits the cards from the lowest bit up: Clubs first, each suit from Two to Ace
+	class const_iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = Card;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = Card;
+
+		constexpr const_iterator() = default;
+		constexpr explicit const_iterator(std::uint64_t remaining)
+			: m_remaining{remaining}
+		{
+		}
+
+		constexpr Card operator*() const
+		{
+			const auto index = static_cast<unsigned>(std::countr_zero(m_remaining));
+			return {static_cast<Rank>(index % bits_per_suit), static_cast<Suit>(index / bits_per_suit)};
+		}
+
+		constexpr const_iterator& operator++()
+		{
+			m_remaining &= m_remaining - 1;
+			return *this;
+		}
+
+		constexpr const_iterator operator++(int)
+		{
+			auto old = *this;
+			++*this;
+			return old;
+		}
+
+		constexpr bool operator==(const const_iterator&) const = default;
+
+	private:
+		std::uint64_t m_remaining = 0; ///< Cards not yet visited
+	};
+
+	constexpr const_iterator begin() const { return const_iterator{m_mask}; }
+	constexpr const_iterator end() const { return const_iterator{}; }
+
+private:
+	static constexpr unsigned bits_per_suit = 16;
+
+	/// Bits 2 (Two) to 14 (Ace) of one suit
+	static constexpr std::uint64_t ranks_of_suit = 0x7ffc;
+
+	/// Bit 0 of each suit
+	static constexpr std::uint64_t suit_repeat = 0x0001'0001'0001'0001;
+
+	static constexpr std::uint64_t bit(const Card& card)
+	{
+		return std::uint64_t{1} << (static_cast<unsigned>(card.suit()) * bits_per_suit +
+																static_cast<unsigned>(card.rank()));
+	}
+
+	std::uint64_t m_mask = 0;
+};
+
+static_assert(std::regular<CardSet>);
+static_assert(std::forward_iterator<CardSet::const_iterator>);
+static_assert(CardSet::full_deck().size() == 52);
+
+/// True if cards are exactly decks full decks, each of the 52 cards appearing decks times.
+/// The n-th copy of a card goes into the n-th set, so a duplicate or missing card leaves some
+/// set short of a full deck.
+inline bool is_full_decks(std::span<const Card> cards, std::size_t decks)
+{
+	if (cards.size() != decks * CardSet::full_deck().size())
+		return false;
+	auto copies = std::vector<CardSet>(decks);
+	for (const auto& card : cards) {
+		auto copy = copies.begin();
+		while (copy != copies.end() && !copy->insert(card))
+			++copy;
+		if (copy == copies.end())
+			return false;
+	}
+	return true;
+}
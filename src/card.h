@@ -1,18 +1,21 @@
 #pragma once
 
+#include <array>
 #include <compare>
 #include <concepts>
-#include <vector>
+#include <cstddef>
+#include <cstdint>
 
 /// Playing card value type.
 /// Equality (==) compares both rank and suit. Ordering (<, <=, >, >=) compares
 /// by rank only — suit is not considered when determining which card is higher,
 /// matching standard card game conventions.
+/// Rank and suit are packed into a single byte, so a deck of 52 cards is 52 bytes.
 struct Card {
 
-	enum class Suit { Clubs, Diamonds, Hearts, Spades };
+	enum class Suit : std::uint8_t { Clubs, Diamonds, Hearts, Spades };
 
-	enum class Rank {
+	enum class Rank : std::uint8_t {
 		Two = 2,
 		Three = 3,
 		Four = 4,
@@ -28,43 +31,58 @@ struct Card {
 		Ace = 14
 	};
 
-	Card() = default;
-	Card(Rank rank, Suit suit)
-		: m_suit{suit}
-		, m_rank{rank}
+	constexpr Card() = default;
+	constexpr Card(Rank rank, Suit suit)
+		: m_bits{pack(rank, suit)}
 	{
 	}
-	Card(Suit suit, Rank rank)
-		: m_suit{suit}
-		, m_rank{rank}
+	constexpr Card(Suit suit, Rank rank)
+		: m_bits{pack(rank, suit)}
 	{
 	}
 
-	[[nodiscard]] Suit suit() const { return m_suit; }
-	[[nodiscard]] Rank rank() const { return m_rank; }
+	[[nodiscard]] constexpr Suit suit() const { return static_cast<Suit>(m_bits >> suit_shift); }
+	[[nodiscard]] constexpr Rank rank() const { return static_cast<Rank>(m_bits & rank_mask); }
 
-	static std::vector<Suit> suits()
-	{
-		return {Suit::Clubs, Suit::Diamonds, Suit::Hearts, Suit::Spades};
-	}
+	/// Every suit, Clubs to Spades
+	static constexpr std::array<Suit, 4> all_suits = {
+		Suit::Clubs, Suit::Diamonds, Suit::Hearts, Suit::Spades};
+
+	/// Every rank, Two to Ace
+	static constexpr std::array<Rank, 13> all_ranks = {
+		Rank::Two,	Rank::Three, Rank::Four, Rank::Five,	Rank::Six,	Rank::Seven, Rank::Eight,
+		Rank::Nine, Rank::Ten,	 Rank::Jack, Rank::Queen, Rank::King, Rank::Ace};
+
+	static constexpr const std::array<Suit, 4>& suits() { return all_suits; }
+	static constexpr const std::array<Rank, 13>& ranks() { return all_ranks; }
 
-	static std::vector<Rank> ranks()
+	/// Position of rank in all_ranks: 0 for Two up to 12 for Ace
+	static constexpr std::size_t rank_index(Rank rank)
 	{
-		return {Rank::Two,	Rank::Three, Rank::Four, Rank::Five,	Rank::Six,	Rank::Seven, Rank::Eight,
-						Rank::Nine, Rank::Ten,	 Rank::Jack, Rank::Queen, Rank::King, Rank::Ace};
+		return static_cast<std::size_t>(rank) - static_cast<std::size_t>(Rank::Two);
 	}
 
 	bool operator==(const Card&) const = default;
 
 	/// Orders by rank only — suit is ignored for ordering purposes.
-	std::strong_ordering operator<=>(const Card& other) const
+	constexpr std::strong_ordering operator<=>(const Card& other) const
 	{
-		return static_cast<int>(m_rank) <=> static_cast<int>(other.m_rank);
+		return (m_bits & rank_mask) <=> (other.m_bits & rank_mask);
 	}
 
 private:
-	Suit m_suit{};
-	Rank m_rank{};
+	/// Rank in the low four bits, suit in the two above
+	static constexpr std::uint8_t rank_mask = 0x0f;
+	static constexpr int suit_shift = 4;
+
+	static constexpr std::uint8_t pack(Rank rank, Suit suit)
+	{
+		return static_cast<std::uint8_t>(static_cast<unsigned>(rank) |
+																		 static_cast<unsigned>(suit) << suit_shift);
+	}
+
+	std::uint8_t m_bits = 0; ///< Default is rank 0 of Clubs, as the two zeroed enums were
 };
 
 static_assert(std::regular<Card>);
+static_assert(sizeof(Card) == 1);
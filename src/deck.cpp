@@ -1,34 +1,54 @@
 ﻿#include "deck.h"
 
-const std::vector<Card>& Deck::cards() const
+std::span<const Card> Deck::cards() const
 {
-	return m_cards;
+	if (!m_cards)
+		return {};
+	return std::span{*m_cards}.subspan(m_top);
 }
 
 Card Deck::deal()
 {
-	return deal(1).front();
+	const auto card = (*m_cards)[m_top++];
+	m_counts.remove(card.rank());
+	return card;
 }
 
-std::vector<Card> Deck::deal(size_t num_cards)
+std::span<const Card> Deck::deal(size_t num_cards)
 {
-	auto hand = std::vector<Card>{};
-	if (num_cards <= m_cards.size()) {
-		const auto b = std::begin(m_cards);
-		const auto m = std::next(b, num_cards);
-		const auto e = std::end(m_cards);
-		hand = {b, m};
-		m_cards = {m, e};
+	auto hand = std::span<const Card>{};
+	if (num_cards <= cards().size()) {
+		hand = cards().first(num_cards);
+		m_top += num_cards;
+		for (const auto& card : hand)
+			m_counts.remove(card.rank());
 	}
 	return hand;
 }
 
-Deck shuffle(const Deck& deck)
+Deck::iterator Deck::begin()
 {
-	std::random_device rd;
-	std::mt19937 rng(rd());
+	if (m_cards.use_count() > 1) {
+		const auto remaining = cards();
+		m_cards = std::make_shared<std::vector<Card>>(remaining.begin(), remaining.end());
+		m_top = 0;
+	}
+	return m_cards ? m_cards->data() + m_top : nullptr;
+}
 
-	auto cards = deck.cards();
-	std::shuffle(begin(cards), end(cards), rng);
-	return {cards};
+Deck shuffle(Deck deck)
+{
+	thread_local auto rng = Rng::from_entropy();
+	return shuffle(std::move(deck), rng);
+}
+
+Deck shuffle(Deck deck, Rng& rng)
+{
+	// Fisher-Yates, in place
+	auto cards = std::span{deck.begin(), deck.end()};
+	for (auto i = cards.size(); i > 1; --i) {
+		const auto j = rng.bounded(static_cast<std::uint32_t>(i));
+		std::swap(cards[i - 1], cards[j]);
+	}
+	return deck;
 }
@@ -1,13 +1,18 @@
 #pragma once
 
 #include "card.h"
+#include "random.h"
+#include "rank-counts.h"
 
 #include <algorithm>
 #include <array>
 #include <concepts>
 #include <iostream>
+#include <memory>
 #include <random>
+#include <ranges>
 #include <span>
+#include <utility>
 #include <vector>
 
 class Deck
@@ -17,7 +22,7 @@ class Deck
 
 public:
 	Deck()
-		: m_cards{{{Rank::Two, Suit::Clubs},			{Rank::Three, Suit::Clubs},
+		: Deck{std::vector<Card>{{Rank::Two, Suit::Clubs},			{Rank::Three, Suit::Clubs},
 							 {Rank::Four, Suit::Clubs},			{Rank::Five, Suit::Clubs},
 							 {Rank::Six, Suit::Clubs},			{Rank::Seven, Suit::Clubs},
 							 {Rank::Eight, Suit::Clubs},		{Rank::Nine, Suit::Clubs},
@@ -51,53 +56,108 @@ public:
 	{
 	}
 
-	Deck(const std::vector<Card>& cards)
-		: m_cards{cards}
+	/// An empty vector shares no storage, so an empty deck costs no allocation
+	Deck(std::vector<Card> cards)
+		: m_cards{cards.empty() ? nullptr : std::make_shared<std::vector<Card>>(std::move(cards))}
+		, m_counts{m_cards ? RankCounts{*m_cards} : RankCounts{}}
 	{
 	}
 
 	Deck(const Deck&) = default;
-	Deck(Deck&&) = default;
+
+	/// A moved-from deck is empty, its composition() included
+	Deck(Deck&& other) noexcept
+		: m_cards{std::move(other.m_cards)}
+		, m_top{std::exchange(other.m_top, 0)}
+		, m_counts{std::exchange(other.m_counts, {})}
+	{
+	}
 
 	Deck& operator=(const Deck&) = default;
-	Deck& operator=(Deck&&) = default;
 
-	bool operator==(const Deck&) const = default;
+	Deck& operator=(Deck&& other) noexcept
+	{
+		m_cards = std::move(other.m_cards);
+		m_top = std::exchange(other.m_top, 0);
+		m_counts = std::exchange(other.m_counts, {});
+		return *this;
+	}
 
-	const std::vector<Card>& cards() const;
+	/// Decks are equal when their remaining cards are equal, regardless of what was dealt
+	bool operator==(const Deck& other) const { return std::ranges::equal(cards(), other.cards()); }
 
+	/// The cards not yet dealt, top of the deck first
+	std::span<const Card> cards() const;
+
+	/// How many of each rank remain, kept up to date as cards are dealt
+	const RankCounts& composition() const { return m_counts; }
+
+	/// Deals the top card. The deck must not be empty.
 	Card deal();
 
-	std::vector<Card> deal(size_t num_cards);
+	/// Deals num_cards off the top, or nothing if fewer remain. The returned view stays valid
+	/// until the deck is assigned to or destroyed.
+	std::span<const Card> deal(size_t num_cards);
 
-	using const_iterator = std::vector<Card>::const_iterator;
-	const_iterator begin() const { return m_cards.cbegin(); }
-	const_iterator end() const { return m_cards.cend(); }
+	using const_iterator = const Card*;
+	const_iterator begin() const { return cards().data(); }
+	const_iterator end() const { return begin() + cards().size(); }
 
-	using iterator = std::vector<Card>::iterator;
-	iterator begin() { return m_cards.begin(); }
-	iterator end() { return m_cards.end(); }
+	/// Mutable access first copies the remaining cards if another deck shares them. It is for
+	/// reordering the cards: composition() is not recounted, so writes must not change them.
+	using iterator = Card*;
+	iterator begin();
+	iterator end() { return begin() + cards().size(); }
 
 private:
-	std::vector<Card> m_cards;
+	/// Copies share the cards; dealing only moves m_top and updates m_counts, so a copy costs a
+	/// reference count and a fixed-size array whatever the size of the deck
+	std::shared_ptr<std::vector<Card>> m_cards;
+	size_t m_top = 0; ///< Index of the next card to deal; cards before it have been dealt
+
+	/// Ranks of the cards from m_top on
+	RankCounts m_counts;
 };
 
 static_assert(std::regular<Deck>);
 
-Deck shuffle(const Deck& deck);
+/// Shuffles with a per-thread engine seeded once from std::random_device
+Deck shuffle(Deck deck);
+
+/// Shuffles with a caller-supplied engine, so a run can be reproduced from its seed
+Deck shuffle(Deck deck, Rng& rng);
+
+/// The suits of cards, read lazily from the cards without copying them
+inline auto suits_of(std::span<const Card> cards)
+{
+	return cards | std::views::transform(&Card::suit);
+}
+
+/// The ranks of cards, read lazily from the cards without copying them
+inline auto ranks_of(std::span<const Card> cards)
+{
+	return cards | std::views::transform(&Card::rank);
+}
+
+/// Counts the cards of each rank into histogram, indexed by Card::rank_index()
+inline void rank_histogram(std::span<const Card> cards,
+													 std::span<std::size_t, Card::all_ranks.size()> histogram)
+{
+	std::ranges::fill(histogram, 0);
+	for (const auto& card : cards)
+		++histogram[Card::rank_index(card.rank())];
+}
 
+/// The suits of cards as a vector; prefer suits_of() where a view will do
 inline std::vector<Card::Suit> slice_suits(std::span<const Card> cards)
 {
-	auto suits = std::vector<Card::Suit>{};
-	std::ranges::transform(cards, std::back_inserter(suits),
-												 [](const auto& card) { return card.suit(); });
-	return suits;
+	const auto suits = suits_of(cards);
+	return std::vector<Card::Suit>(suits.begin(), suits.end());
 }
 
+/// The ranks of cards as a vector; prefer ranks_of() where a view will do
 inline std::vector<Card::Rank> slice_face_values(std::span<const Card> cards)
 {
-	auto values = std::vector<Card::Rank>{};
-	std::ranges::transform(cards, std::back_inserter(values),
-												 [](const auto& card) { return card.rank(); });
-	return values;
+	const auto ranks = ranks_of(cards);
+	return std::vector<Card::Rank>(ranks.begin(), ranks.end());
 }
@@ -0,0 +1,352 @@
+#include "hand-batch.h"
+
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define HAND_BATCH_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HAND_BATCH_SSE2
+#endif
+
+namespace CardGames::BlackJack
+{
+	namespace
+	{
+		constexpr auto ace = static_cast<std::uint8_t>(Card::Rank::Ace);
+
+		/// Highest hard total at which an ace can still count as 11
+		constexpr std::uint8_t max_soft_total = 11;
+
+		std::size_t padded(std::size_t hand_count)
+		{
+			return (hand_count + HandBatch::lanes - 1) / HandBatch::lanes * HandBatch::lanes;
+		}
+
+		void resize(const HandBatch& batch, HandBatchValues& values)
+		{
+			values.totals.resize(batch.stride());
+			values.soft.resize(batch.stride());
+		}
+
+		// Every evaluator computes, per byte: points = min(rank, 10), or 1 for an ace; the hard
+		// total sums the points; a hand is soft if it holds an ace and its hard total is at most
+		// max_soft_total, and its total is then the hard total plus 10. Empty slots are 0 and
+		// add nothing.
+
+#if defined(HAND_BATCH_AVX2)
+		void evaluate_vector(const HandBatch& batch, HandBatchValues& values)
+		{
+			const auto aces = _mm256_set1_epi8(static_cast<char>(ace));
+			const auto tens = _mm256_set1_epi8(10);
+			const auto ones = _mm256_set1_epi8(1);
+			const auto max_soft = _mm256_set1_epi8(max_soft_total);
+
+			for (std::size_t h = 0; h < batch.stride(); h += 32) {
+				auto hard = _mm256_setzero_si256();
+				auto has_ace = _mm256_setzero_si256();
+				for (std::size_t c = 0; c < batch.max_hand_size(); ++c) {
+					const auto ranks =
+						_mm256_loadu_si256(reinterpret_cast<const __m256i*>(batch.slot(c).data() + h));
+					const auto is_ace = _mm256_cmpeq_epi8(ranks, aces);
+					const auto points = _mm256_blendv_epi8(_mm256_min_epu8(ranks, tens), ones, is_ace);
+					hard = _mm256_adds_epu8(hard, points);
+					has_ace = _mm256_or_si256(has_ace, is_ace);
+				}
+				const auto below_max = _mm256_cmpeq_epi8(_mm256_min_epu8(hard, max_soft), hard);
+				const auto soft = _mm256_and_si256(has_ace, below_max);
+				const auto total = _mm256_add_epi8(hard, _mm256_and_si256(soft, tens));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(values.totals.data() + h), total);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(values.soft.data() + h),
+														_mm256_and_si256(soft, ones));
+			}
+		}
+#elif defined(HAND_BATCH_SSE2)
+		void evaluate_vector(const HandBatch& batch, HandBatchValues& values)
+		{
+			const auto aces = _mm_set1_epi8(static_cast<char>(ace));
+			const auto tens = _mm_set1_epi8(10);
+			const auto ones = _mm_set1_epi8(1);
+			const auto max_soft = _mm_set1_epi8(max_soft_total);
+
+			for (std::size_t h = 0; h < batch.stride(); h += 16) {
+				auto hard = _mm_setzero_si128();
+				auto has_ace = _mm_setzero_si128();
+				for (std::size_t c = 0; c < batch.max_hand_size(); ++c) {
+					const auto ranks =
+						_mm_loadu_si128(reinterpret_cast<const __m128i*>(batch.slot(c).data() + h));
+					const auto is_ace = _mm_cmpeq_epi8(ranks, aces);
+					// SSE2 has no byte blend, so select with and/andnot
+					const auto points = _mm_or_si128(_mm_andnot_si128(is_ace, _mm_min_epu8(ranks, tens)),
+																					 _mm_and_si128(is_ace, ones));
+					hard = _mm_adds_epu8(hard, points);
+					has_ace = _mm_or_si128(has_ace, is_ace);
+				}
+				const auto below_max = _mm_cmpeq_epi8(_mm_min_epu8(hard, max_soft), hard);
+				const auto soft = _mm_and_si128(has_ace, below_max);
+				const auto total = _mm_add_epi8(hard, _mm_and_si128(soft, tens));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(values.totals.data() + h), total);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(values.soft.data() + h),
+												 _mm_and_si128(soft, ones));
+			}
+		}
+#endif
+
+		void resize(const DealerBatch& batch, DealerTurns& turns)
+		{
+			turns.totals.resize(batch.stride());
+			turns.soft.resize(batch.stride());
+			turns.draws.resize(batch.stride());
+		}
+
+		// Every dealer turn computes, per byte: the hand is soft while it holds an ace and its
+		// hard total is at most max_soft_total, and the dealer hits while it plays and its
+		// total is at most 16, or is a soft 17 under hit_soft_17. A hit adds the next draw's
+		// points as evaluate() counts them. Drawing stops once no dealer hits, and a dealer that
+		// stops never hits again, since its cards no longer change.
+
+#if defined(HAND_BATCH_AVX2)
+		void play_dealer_turns_vector(const DealerBatch& batch, bool hit_soft_17, DealerTurns& turns)
+		{
+			const auto aces = _mm256_set1_epi8(static_cast<char>(ace));
+			const auto tens = _mm256_set1_epi8(10);
+			const auto ones = _mm256_set1_epi8(1);
+			const auto max_soft = _mm256_set1_epi8(max_soft_total);
+			const auto sixteens = _mm256_set1_epi8(16);
+			const auto seventeens = _mm256_set1_epi8(17);
+			const auto soft_17_hits = _mm256_set1_epi8(hit_soft_17 ? -1 : 0);
+
+			const auto load = [](std::span<const std::uint8_t> bytes, std::size_t h) {
+				return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes.data() + h));
+			};
+			const auto store = [](std::vector<std::uint8_t>& bytes, std::size_t h, __m256i v) {
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(bytes.data() + h), v);
+			};
+
+			for (std::size_t h = 0; h < batch.stride(); h += 32) {
+				auto hard = load(batch.hard_totals(), h);
+				auto has_ace = _mm256_cmpeq_epi8(load(batch.soft(), h), ones);
+				const auto plays = _mm256_cmpeq_epi8(load(batch.plays(), h), ones);
+				auto draws = _mm256_setzero_si256();
+				auto soft =
+					_mm256_and_si256(has_ace, _mm256_cmpeq_epi8(_mm256_min_epu8(hard, max_soft), hard));
+				auto total = _mm256_add_epi8(hard, _mm256_and_si256(soft, tens));
+				for (std::size_t d = 0; d < DealerBatch::max_draws; ++d) {
+					const auto below_17 = _mm256_cmpeq_epi8(_mm256_min_epu8(total, sixteens), total);
+					const auto soft_17 = _mm256_and_si256(_mm256_and_si256(soft, soft_17_hits),
+																								_mm256_cmpeq_epi8(total, seventeens));
+					const auto hits = _mm256_and_si256(plays, _mm256_or_si256(below_17, soft_17));
+					if (_mm256_movemask_epi8(hits) == 0)
+						break;
+					const auto ranks = load(batch.draw(d), h);
+					const auto is_ace = _mm256_cmpeq_epi8(ranks, aces);
+					const auto points = _mm256_blendv_epi8(_mm256_min_epu8(ranks, tens), ones, is_ace);
+					hard = _mm256_add_epi8(hard, _mm256_and_si256(points, hits));
+					has_ace = _mm256_or_si256(has_ace, _mm256_and_si256(is_ace, hits));
+					draws = _mm256_sub_epi8(draws, hits); // hits are -1
+					soft =
+						_mm256_and_si256(has_ace, _mm256_cmpeq_epi8(_mm256_min_epu8(hard, max_soft), hard));
+					total = _mm256_add_epi8(hard, _mm256_and_si256(soft, tens));
+				}
+				store(turns.totals, h, total);
+				store(turns.soft, h, _mm256_and_si256(soft, ones));
+				store(turns.draws, h, draws);
+			}
+		}
+#elif defined(HAND_BATCH_SSE2)
+		void play_dealer_turns_vector(const DealerBatch& batch, bool hit_soft_17, DealerTurns& turns)
+		{
+			const auto aces = _mm_set1_epi8(static_cast<char>(ace));
+			const auto tens = _mm_set1_epi8(10);
+			const auto ones = _mm_set1_epi8(1);
+			const auto max_soft = _mm_set1_epi8(max_soft_total);
+			const auto sixteens = _mm_set1_epi8(16);
+			const auto seventeens = _mm_set1_epi8(17);
+			const auto soft_17_hits = _mm_set1_epi8(hit_soft_17 ? -1 : 0);
+
+			const auto load = [](std::span<const std::uint8_t> bytes, std::size_t h) {
+				return _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes.data() + h));
+			};
+			const auto store = [](std::vector<std::uint8_t>& bytes, std::size_t h, __m128i v) {
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(bytes.data() + h), v);
+			};
+
+			for (std::size_t h = 0; h < batch.stride(); h += 16) {
+				auto hard = load(batch.hard_totals(), h);
+				auto has_ace = _mm_cmpeq_epi8(load(batch.soft(), h), ones);
+				const auto plays = _mm_cmpeq_epi8(load(batch.plays(), h), ones);
+				auto draws = _mm_setzero_si128();
+				auto soft = _mm_and_si128(has_ace, _mm_cmpeq_epi8(_mm_min_epu8(hard, max_soft), hard));
+				auto total = _mm_add_epi8(hard, _mm_and_si128(soft, tens));
+				for (std::size_t d = 0; d < DealerBatch::max_draws; ++d) {
+					const auto below_17 = _mm_cmpeq_epi8(_mm_min_epu8(total, sixteens), total);
+					const auto soft_17 =
+						_mm_and_si128(_mm_and_si128(soft, soft_17_hits), _mm_cmpeq_epi8(total, seventeens));
+					const auto hits = _mm_and_si128(plays, _mm_or_si128(below_17, soft_17));
+					if (_mm_movemask_epi8(hits) == 0)
+						break;
+					const auto ranks = load(batch.draw(d), h);
+					const auto is_ace = _mm_cmpeq_epi8(ranks, aces);
+					// SSE2 has no byte blend, so select with and/andnot
+					const auto points = _mm_or_si128(_mm_andnot_si128(is_ace, _mm_min_epu8(ranks, tens)),
+																					 _mm_and_si128(is_ace, ones));
+					hard = _mm_add_epi8(hard, _mm_and_si128(points, hits));
+					has_ace = _mm_or_si128(has_ace, _mm_and_si128(is_ace, hits));
+					draws = _mm_sub_epi8(draws, hits); // hits are -1
+					soft = _mm_and_si128(has_ace, _mm_cmpeq_epi8(_mm_min_epu8(hard, max_soft), hard));
+					total = _mm_add_epi8(hard, _mm_and_si128(soft, tens));
+				}
+				store(turns.totals, h, total);
+				store(turns.soft, h, _mm_and_si128(soft, ones));
+				store(turns.draws, h, draws);
+			}
+		}
+#endif
+	} // namespace
+
+	HandBatch::HandBatch(std::size_t hand_count)
+		: m_size{hand_count}
+		, m_stride{padded(hand_count)}
+		, m_ranks(max_cards * m_stride)
+		, m_hand_sizes(hand_count)
+	{
+	}
+
+	void HandBatch::add(std::size_t hand, const Card& card)
+	{
+		auto& size = m_hand_sizes[hand];
+		m_ranks[size * m_stride + hand] = static_cast<std::uint8_t>(card.rank());
+		++size;
+		m_max_hand_size = std::max<std::size_t>(m_max_hand_size, size);
+	}
+
+	void HandBatch::assign(std::size_t hand, std::span<const Card> cards)
+	{
+		for (auto c = cards.size(); c < m_hand_sizes[hand]; ++c)
+			m_ranks[c * m_stride + hand] = 0;
+		m_hand_sizes[hand] = 0;
+		for (const auto& card : cards)
+			add(hand, card);
+	}
+
+	void HandBatch::clear()
+	{
+		std::ranges::fill(m_ranks, 0);
+		std::ranges::fill(m_hand_sizes, 0);
+		m_max_hand_size = 0;
+	}
+
+	void evaluate_scalar(const HandBatch& batch, HandBatchValues& values)
+	{
+		resize(batch, values);
+		for (std::size_t h = 0; h < batch.stride(); ++h) {
+			auto hard = 0;
+			auto has_ace = false;
+			for (std::size_t c = 0; c < batch.max_hand_size(); ++c) {
+				const auto rank = batch.slot(c)[h];
+				hard += rank == ace ? 1 : std::min<int>(rank, 10);
+				has_ace |= rank == ace;
+			}
+			const auto soft = has_ace && hard <= max_soft_total;
+			values.totals[h] = static_cast<std::uint8_t>(hard + (soft ? 10 : 0));
+			values.soft[h] = soft;
+		}
+	}
+
+	void evaluate(const HandBatch& batch, HandBatchValues& values)
+	{
+#if defined(HAND_BATCH_AVX2) || defined(HAND_BATCH_SSE2)
+		resize(batch, values);
+		evaluate_vector(batch, values);
+#else
+		evaluate_scalar(batch, values);
+#endif
+	}
+
+	HandBatchValues evaluate(const HandBatch& batch)
+	{
+		auto values = HandBatchValues{};
+		evaluate(batch, values);
+		return values;
+	}
+
+	DealerBatch::DealerBatch(std::size_t round_count)
+	{
+		reset(round_count);
+	}
+
+	void DealerBatch::assign(std::size_t round, const HandValue& value, std::span<const Card> cards)
+	{
+		m_hard_totals[round] = static_cast<std::uint8_t>(value.total - 10 * value.soft_ace_count);
+		m_soft[round] = value.is_soft;
+		m_plays[round] = 1;
+		// A dealer stands on any hard 17, so the cards after the one reaching it are never
+		// drawn and their slots can keep whatever they held
+		auto hard = static_cast<int>(m_hard_totals[round]);
+		const auto count = std::min(cards.size(), max_draws);
+		for (std::size_t d = 0; d < count && hard < 17; ++d) {
+			const auto rank = static_cast<std::uint8_t>(cards[d].rank());
+			m_draws[d * m_stride + round] = rank;
+			hard += rank == ace ? 1 : std::min<int>(rank, 10);
+		}
+	}
+
+	void DealerBatch::skip(std::size_t round)
+	{
+		m_plays[round] = 0;
+	}
+
+	void DealerBatch::reset(std::size_t round_count)
+	{
+		m_size = round_count;
+		m_stride = padded(round_count);
+		m_hard_totals.assign(m_stride, 0);
+		m_soft.assign(m_stride, 0);
+		m_plays.assign(m_stride, 0);
+		m_draws.resize(max_draws * m_stride);
+	}
+
+	void play_dealer_turns_scalar(const DealerBatch& batch, bool hit_soft_17, DealerTurns& turns)
+	{
+		resize(batch, turns);
+		for (std::size_t h = 0; h < batch.stride(); ++h) {
+			auto hard = static_cast<int>(batch.hard_totals()[h]);
+			auto has_ace = batch.soft()[h] != 0;
+			auto draws = 0;
+			const auto is_soft = [&] { return has_ace && hard <= max_soft_total; };
+			const auto total = [&] { return hard + (is_soft() ? 10 : 0); };
+			while (batch.plays()[h] != 0 && draws < static_cast<int>(DealerBatch::max_draws) &&
+						 (total() < 17 || (total() == 17 && is_soft() && hit_soft_17))) {
+				const auto rank = batch.draw(draws)[h];
+				hard += rank == ace ? 1 : std::min<int>(rank, 10);
+				has_ace |= rank == ace;
+				++draws;
+			}
+			turns.totals[h] = static_cast<std::uint8_t>(total());
+			turns.soft[h] = is_soft();
+			turns.draws[h] = static_cast<std::uint8_t>(draws);
+		}
+	}
+
+	void play_dealer_turns(const DealerBatch& batch, bool hit_soft_17, DealerTurns& turns)
+	{
+#if defined(HAND_BATCH_AVX2) || defined(HAND_BATCH_SSE2)
+		resize(batch, turns);
+		play_dealer_turns_vector(batch, hit_soft_17, turns);
+#else
+		play_dealer_turns_scalar(batch, hit_soft_17, turns);
+#endif
+	}
+
+	std::string_view hand_batch_instruction_set()
+	{
+#if defined(HAND_BATCH_AVX2)
+		return "AVX2";
+#elif defined(HAND_BATCH_SSE2)
+		return "SSE2";
+#else
+		return "scalar";
+#endif
+	}
+} // namespace CardGames::BlackJack
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "blackjack-game.h"
+#include "card.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace CardGames::BlackJack
+{
+	/// Many hands stored rank by rank for batch evaluation: card slot c of every hand is
+	/// contiguous, one byte per hand, so a vector instruction reads the same slot of 16 or 32
+	/// hands at once. Empty slots hold 0.
+	class HandBatch
+	{
+	public:
+		/// Most cards a hand can hold, as in a game. Twenty-two tens are 220, so totals always fit
+		/// in a byte.
+		static constexpr std::size_t max_cards = max_hand_cards;
+		static_assert(max_cards * 10 <= 255);
+
+		/// Hands are padded to a multiple of this, the widest vector the evaluator uses
+		static constexpr std::size_t lanes = 32;
+
+		HandBatch() = default;
+
+		/// A batch of hand_count empty hands
+		explicit HandBatch(std::size_t hand_count);
+
+		/// Number of hands
+		std::size_t size() const { return m_size; }
+
+		/// Number of hands including padding; each card slot is this many bytes
+		std::size_t stride() const { return m_stride; }
+
+		/// Number of cards in the largest hand, and so the slots evaluate() reads
+		std::size_t max_hand_size() const { return m_max_hand_size; }
+
+		std::size_t hand_size(std::size_t hand) const { return m_hand_sizes[hand]; }
+
+		/// Adds card to a hand. The hand must hold fewer than max_cards.
+		void add(std::size_t hand, const Card& card);
+
+		/// Replaces a hand's cards. There must be at most max_cards.
+		void assign(std::size_t hand, std::span<const Card> cards);
+
+		/// Empties every hand, keeping the storage
+		void clear();
+
+		/// The ranks in card slot c of every hand, including padding
+		std::span<const std::uint8_t> slot(std::size_t c) const
+		{
+			return std::span{m_ranks}.subspan(c * m_stride, m_stride);
+		}
+
+	private:
+		std::size_t m_size = 0;
+		std::size_t m_stride = 0;
+		std::size_t m_max_hand_size = 0;
+		std::vector<std::uint8_t> m_ranks; ///< max_cards slots of m_stride rank values
+		std::vector<std::uint8_t> m_hand_sizes;
+	};
+
+	/// Values of a batch of hands, one byte per hand. Both vectors cover the batch's stride();
+	/// the padding hands are empty and worth 0.
+	struct HandBatchValues {
+		std::vector<std::uint8_t> totals;
+		std::vector<std::uint8_t> soft; ///< 1 if an Ace counts as 11, else 0
+
+		/// The value of one hand, as calculate_hand_value() would give it
+		HandValue operator[](std::size_t hand) const
+		{
+			return {totals[hand], soft[hand] != 0, soft[hand]};
+		}
+	};
+
+	/// Evaluates every hand in the batch with the widest vector instructions the build targets
+	/// (AVX2, then SSE2), falling back to evaluate_scalar() elsewhere. values is resized to
+	/// the batch, so reusing it across calls avoids allocating.
+	void evaluate(const HandBatch& batch, HandBatchValues& values);
+
+	HandBatchValues evaluate(const HandBatch& batch);
+
+	/// The portable evaluator, one hand at a time
+	void evaluate_scalar(const HandBatch& batch, HandBatchValues& values);
+
+	/// Dealer turns of many independent rounds, stored like a HandBatch so they play in lockstep:
+	/// each round's dealer value is one byte per round, and the cards its dealer would draw
+	/// are stored draw by draw, with draw d of every round contiguous.
+	class DealerBatch
+	{
+	public:
+		/// Most cards a dealer can draw. A dealer starts on two cards, worth a hard total of at
+		/// least 2, hits only on a hard total of at most 16 and stands on any hard 17.
+		static constexpr std::size_t max_draws = 15;
+
+		/// Rounds are padded to a multiple of this, as hands of a HandBatch are
+		static constexpr std::size_t lanes = HandBatch::lanes;
+
+		DealerBatch() = default;
+
+		/// A batch of round_count rounds in which no dealer plays
+		explicit DealerBatch(std::size_t round_count);
+
+		/// Number of rounds
+		std::size_t size() const { return m_size; }
+
+		/// Number of rounds including padding; each draw is this many bytes
+		std::size_t stride() const { return m_stride; }
+
+		/// Has the dealer of a round play from a hand worth value, drawing from the front of
+		/// cards. Only the cards the dealer could draw are read, at most max_draws, and there
+		/// must be enough for the turn.
+		void assign(std::size_t round, const HandValue& value, std::span<const Card> cards);
+
+		/// Has the dealer of a round not play, as when the player busted or either had blackjack
+		void skip(std::size_t round);
+
+		/// Makes it a batch of round_count rounds in which no dealer plays, keeping the storage
+		/// when it is large enough
+		void reset(std::size_t round_count);
+
+		/// The hard totals the dealers start from, including padding
+		std::span<const std::uint8_t> hard_totals() const { return m_hard_totals; }
+
+		/// 1 for each dealer holding an ace that counts as 11, including padding
+		std::span<const std::uint8_t> soft() const { return m_soft; }
+
+		/// 1 for each dealer who plays, including padding
+		std::span<const std::uint8_t> plays() const { return m_plays; }
+
+		/// The ranks of draw d of every round, including padding. A round's slots past the card
+		/// that would bring its dealer to a hard 17 are never drawn and may hold anything.
+		std::span<const std::uint8_t> draw(std::size_t d) const
+		{
+			return std::span{m_draws}.subspan(d * m_stride, m_stride);
+		}
+
+	private:
+		std::size_t m_size = 0;
+		std::size_t m_stride = 0;
+		std::vector<std::uint8_t> m_hard_totals;
+		std::vector<std::uint8_t> m_soft;
+		std::vector<std::uint8_t> m_plays;
+		std::vector<std::uint8_t> m_draws; ///< max_draws slots of m_stride rank values
+	};
+
+	/// How the dealers of a DealerBatch finished, one byte per round. Every vector covers the
+	/// batch's stride(); rounds whose dealer didn't play keep their starting value.
+	struct DealerTurns {
+		std::vector<std::uint8_t> totals;
+		std::vector<std::uint8_t> soft; ///< 1 if an Ace counts as 11, else 0
+		std::vector<std::uint8_t> draws; ///< Number of cards drawn
+
+		/// The value of one dealer's final hand, as calculate_hand_value() would give it
+		HandValue operator[](std::size_t round) const
+		{
+			return {totals[round], soft[round] != 0, soft[round]};
+		}
+	};
+
+	/// Plays every dealer's turn in lockstep, drawing while a dealer's total is below 17, or is
+	/// a soft 17 and hit_soft_17 is set, with the widest vector instructions the build targets,
+	/// as evaluate() does. turns is resized to the batch, so reusing it avoids allocating.
+	void play_dealer_turns(const DealerBatch& batch, bool hit_soft_17, DealerTurns& turns);
+
+	/// The portable version of play_dealer_turns(), one round at a time
+	void play_dealer_turns_scalar(const DealerBatch& batch, bool hit_soft_17, DealerTurns& turns);
+
+	/// Name of the instruction set evaluate() and play_dealer_turns() use in this build
+	std::string_view hand_batch_instruction_set();
+} // namespace CardGames::BlackJack
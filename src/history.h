@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/// How much of a game's history is kept
+enum class HistoryRetention {
+	Full,				 ///< Every state since the round started
+	LastN,			 ///< The most recent HistoryConfig::depth states
+	CurrentOnly, ///< Only the current state
+};
+
+/// Configuration of a game's history
+struct HistoryConfig {
+	HistoryRetention retention = HistoryRetention::Full;
+	std::size_t depth = 16; ///< States kept under LastN; at least one is always kept
+
+	bool operator==(const HistoryConfig&) const = default;
+};
+
+/// Sequence of states that keeps all of them or only the most recent, per its config. Once the
+/// limit is reached each new state overwrites the oldest, so memory stays flat however many
+/// states are appended.
+///
+/// States are stored in segments of SegmentSize that are allocated once and never grow, so
+/// appending never moves a state: a reference stays valid until clear(), or under a limit,
+/// until its slot is overwritten. A copy gets segments of its own with the same guarantee.
+template <typename T, std::size_t SegmentSize = 16>
+class History
+{
+public:
+	History() = default;
+
+	explicit History(HistoryConfig config)
+		: m_limit{limit(config)}
+	{
+	}
+
+	/// Copies the states into segments reserved to SegmentSize, as the implicit copy would
+	/// shrink them to fit and the next append would then move states
+	History(const History& other)
+		: m_size{other.m_size}
+		, m_head{other.m_head}
+		, m_limit{other.m_limit}
+	{
+		m_segments.reserve(other.m_segments.size());
+		for (const auto& other_segment : other.m_segments) {
+			auto& segment = m_segments.emplace_back();
+			segment.reserve(SegmentSize);
+			segment.insert(segment.end(), other_segment.begin(), other_segment.end());
+		}
+	}
+
+	History(History&& other) noexcept
+		: m_segments{std::move(other.m_segments)}
+		, m_size{std::exchange(other.m_size, 0)}
+		, m_head{std::exchange(other.m_head, 0)}
+		, m_limit{other.m_limit}
+	{
+	}
+
+	History& operator=(const History& other)
+	{
+		if (this != &other)
+			*this = History(other);
+		return *this;
+	}
+
+	History& operator=(History&& other) noexcept
+	{
+		m_segments = std::move(other.m_segments);
+		m_size = std::exchange(other.m_size, 0);
+		m_head = std::exchange(other.m_head, 0);
+		m_limit = other.m_limit;
+		return *this;
+	}
+
+	~History() = default;
+
+	/// Number of states retained
+	std::size_t size() const { return m_size; }
+	bool empty() const { return m_size == 0; }
+
+	/// Most states retained at once
+	std::size_t capacity_limit() const { return m_limit; }
+
+	/// The i-th retained state, oldest first
+	const T& operator[](std::size_t i) const { return slot((m_head + i) % m_size); }
+
+	const T& front() const { return (*this)[0]; }
+	const T& back() const { return (*this)[m_size - 1]; }
+	T& back() { return slot((m_head + m_size - 1) % m_size); }
+
+	/// True if the next state appended overwrites back(), which may then be moved from first
+	bool replaces_back() const { return m_size == 1 && m_limit == 1; }
+
+	/// Appends a state built from args, which may refer to retained states
+	template <typename... Args>
+	const T& emplace_back(Args&&... args)
+	{
+		if (m_size < m_limit) {
+			if (m_size / SegmentSize == m_segments.size()) {
+				m_segments.emplace_back().reserve(SegmentSize);
+			}
+			auto& state = m_segments[m_size / SegmentSize].emplace_back(std::forward<Args>(args)...);
+			++m_size;
+			return state;
+		}
+		// Build the new state before the oldest, which args may refer to, is overwritten
+		auto state = T(std::forward<Args>(args)...);
+		auto& oldest = slot(m_head);
+		oldest = std::move(state);
+		m_head = (m_head + 1) % m_size;
+		return oldest;
+	}
+
+	const T& push_back(T state) { return emplace_back(std::move(state)); }
+
+	/// Removes all states, keeping the segments for the next ones
+	void clear()
+	{
+		for (auto& segment : m_segments)
+			segment.clear();
+		m_size = 0;
+		m_head = 0;
+	}
+
+private:
+	static std::size_t limit(HistoryConfig config)
+	{
+		switch (config.retention) {
+			case HistoryRetention::Full: return std::numeric_limits<std::size_t>::max();
+			case HistoryRetention::LastN: return config.depth > 0 ? config.depth : 1;
+			case HistoryRetention::CurrentOnly: return 1;
+		}
+		return 1;
+	}
+
+	const T& slot(std::size_t i) const { return m_segments[i / SegmentSize][i % SegmentSize]; }
+	T& slot(std::size_t i) { return m_segments[i / SegmentSize][i % SegmentSize]; }
+
+	/// Each segment is reserved to SegmentSize and never exceeds it, so it never reallocates;
+	/// adding segments moves only the segment handles
+	std::vector<std::vector<T>> m_segments;
+	std::size_t m_size = 0;
+	std::size_t m_head = 0; ///< Slot of the oldest state once the limit is reached
+	std::size_t m_limit = std::numeric_limits<std::size_t>::max();
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <span>
+
+/// Sequence of at most Capacity elements stored inline, so it never allocates and copying it
+/// copies a fixed block of memory. Elements past size() stay value-initialized.
+///
+/// Exceeding Capacity is a precondition violation, as dealing from an empty Deck is.
+template <typename T, std::size_t Capacity>
+class InlineVector
+{
+public:
+	using value_type = T;
+	using size_type = std::size_t;
+	using iterator = T*;
+	using const_iterator = const T*;
+
+	constexpr InlineVector() = default;
+
+	constexpr InlineVector(std::initializer_list<T> items)
+		: InlineVector(std::span<const T>{items.begin(), items.size()})
+	{
+	}
+
+	/// A copy of items, of which there must be at most Capacity
+	constexpr explicit InlineVector(std::span<const T> items)
+		: m_size{items.size()}
+	{
+		std::ranges::copy(items, m_items.begin());
+	}
+
+	static constexpr size_type capacity() { return Capacity; }
+	constexpr size_type size() const { return m_size; }
+	constexpr bool empty() const { return m_size == 0; }
+
+	constexpr T* data() { return m_items.data(); }
+	constexpr const T* data() const { return m_items.data(); }
+
+	constexpr iterator begin() { return data(); }
+	constexpr iterator end() { return data() + m_size; }
+	constexpr const_iterator begin() const { return data(); }
+	constexpr const_iterator end() const { return data() + m_size; }
+
+	constexpr T& operator[](size_type i) { return m_items[i]; }
+	constexpr const T& operator[](size_type i) const { return m_items[i]; }
+
+	constexpr T& front() { return m_items[0]; }
+	constexpr const T& front() const { return m_items[0]; }
+	constexpr T& back() { return m_items[m_size - 1]; }
+	constexpr const T& back() const { return m_items[m_size - 1]; }
+
+	/// Appends item. There must be fewer than Capacity elements.
+	constexpr void push_back(const T& item) { m_items[m_size++] = item; }
+
+	constexpr void pop_back() { m_items[--m_size] = T{}; }
+
+	/// Inserts item before pos, shifting the later elements along in place. There must be fewer
+	/// than Capacity elements.
+	constexpr iterator insert(const_iterator pos, const T& item)
+	{
+		const auto at = begin() + (pos - begin());
+		std::move_backward(at, end(), end() + 1);
+		*at = item;
+		++m_size;
+		return at;
+	}
+
+	constexpr void clear()
+	{
+		std::fill_n(m_items.begin(), m_size, T{});
+		m_size = 0;
+	}
+
+	/// Equal when the elements are; unused slots are always value-initialized so they compare
+	/// equal too
+	constexpr bool operator==(const InlineVector&) const = default;
+
+private:
+	std::array<T, Capacity> m_items = {};
+	size_type m_size = 0;
+};
@@ -33,8 +33,10 @@ namespace blackjack_io
 		std::cout << line << std::endl;
 	}
 
-	CardGames::BlackJack::Game::Play get_move(bool can_split)
+	CardGames::BlackJack::Play get_move(CardGames::BlackJack::PlaySet legal_moves)
 	{
+		using CardGames::BlackJack::Play;
+		const auto can_split = legal_moves.contains(Play::Split);
 		auto user_input = 0;
 		auto user_input_is_valid = true;
 		do {
@@ -48,14 +50,15 @@ namespace blackjack_io
 			}
 			user_input = std::cin.get();
 			std::cin.get(); // flush out 'Enter'
-			user_input_is_valid =
-				user_input == 'h' || user_input == 's' || (can_split && user_input == 'p');
+			user_input_is_valid = (user_input == 'h' && legal_moves.contains(Play::Hit)) ||
+														(user_input == 's' && legal_moves.contains(Play::Stay)) ||
+														(user_input == 'p' && legal_moves.contains(Play::Split));
 		} while (!user_input_is_valid);
 
 		switch (user_input) {
-			case 'h': return CardGames::BlackJack::Game::Play::Hit;
-			case 's': return CardGames::BlackJack::Game::Play::Stay;
-			case 'p': return CardGames::BlackJack::Game::Play::Split;
+			case 'h': return Play::Hit;
+			case 's': return Play::Stay;
+			case 'p': return Play::Split;
 			default: {
 				std::cout << "Invalid move: " << user_input << "\nQuitting game.";
 				exit(1);
@@ -149,8 +152,7 @@ void play_blackjack(CardGames::BlackJack::BlackjackConfig config = {})
 
 	// Player's turn - handles both normal and split rounds
 	while (state.node() == PlayersRound || state.node() == PlayersSplitRound) {
-		const auto can_split = state.can_split();
-		const auto players_move = blackjack_io::get_move(can_split);
+		const auto players_move = blackjack_io::get_move(state.legal_moves());
 		state = game.next(players_move);
 		blackjack_io::print_game_state(state);
 	}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+/// Fast, seedable, non-cryptographic random engine (xoshiro256**).
+/// Satisfies std::uniform_random_bit_generator, so it also works with <random> and <algorithm>.
+class Rng
+{
+public:
+	using result_type = std::uint64_t;
+
+	/// Seeds the engine from a single value. Different streams of the same seed are
+	/// independent, which lets parallel work derive one engine per unit of work.
+	explicit constexpr Rng(std::uint64_t seed = 0, std::uint64_t stream = 0)
+	{
+		auto sm = seed ^ splitmix64(stream);
+		for (auto& word : m_state) {
+			word = splitmix64(sm);
+		}
+	}
+
+	/// Seeds the engine from std::random_device
+	static Rng from_entropy()
+	{
+		auto rd = std::random_device{};
+		return Rng{(std::uint64_t{rd()} << 32) | rd()};
+	}
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+	constexpr result_type operator()()
+	{
+		const auto result = std::rotl(m_state[1] * 5, 7) * 9;
+		const auto t = m_state[1] << 17;
+		m_state[2] ^= m_state[0];
+		m_state[3] ^= m_state[1];
+		m_state[1] ^= m_state[2];
+		m_state[0] ^= m_state[3];
+		m_state[2] ^= t;
+		m_state[3] = std::rotl(m_state[3], 45);
+		return result;
+	}
+
+	/// Uniform integer in [0, bound) by Lemire's multiply-shift method. Unlike
+	/// std::uniform_int_distribution it needs no division except on the rare rejection path.
+	constexpr std::uint32_t bounded(std::uint32_t bound)
+	{
+		auto product = std::uint64_t{static_cast<std::uint32_t>((*this)() >> 32)} * bound;
+		auto low = static_cast<std::uint32_t>(product);
+		if (low < bound) {
+			const auto threshold = static_cast<std::uint32_t>(-bound) % bound;
+			while (low < threshold) {
+				product = std::uint64_t{static_cast<std::uint32_t>((*this)() >> 32)} * bound;
+				low = static_cast<std::uint32_t>(product);
+			}
+		}
+		return static_cast<std::uint32_t>(product >> 32);
+	}
+
+	bool operator==(const Rng&) const = default;
+
+private:
+	static constexpr std::uint64_t splitmix64(std::uint64_t& state)
+	{
+		auto z = (state += 0x9e3779b97f4a7c15);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+		return z ^ (z >> 31);
+	}
+
+	std::array<std::uint64_t, 4> m_state{};
+};
+
+static_assert(std::uniform_random_bit_generator<Rng>);
+static_assert(std::regular<Rng>);
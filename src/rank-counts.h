@@ -0,0 +1,75 @@
+#pragma once
+
+#include "card.h"
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/// Number of cards of each rank in a deck or shoe. Every query is a lookup, so a deck can keep
+/// its counts up to date as it deals and answer "how many tens are left" without a scan.
+class RankCounts
+{
+	using Rank = Card::Rank;
+
+public:
+	constexpr RankCounts() = default;
+
+	explicit constexpr RankCounts(std::span<const Card> cards)
+	{
+		for (const auto& card : cards)
+			add(card.rank());
+	}
+
+	/// Number of cards of rank
+	constexpr std::size_t count(Rank rank) const { return m_counts[index(rank)]; }
+
+	/// Number of Tens, Jacks, Queens and Kings, the cards worth 10
+	constexpr std::size_t ten_valued() const
+	{
+		return std::size_t{m_counts[index(Rank::Ten)]} + m_counts[index(Rank::Jack)] +
+					 m_counts[index(Rank::Queen)] + m_counts[index(Rank::King)];
+	}
+
+	/// Number of cards of every rank
+	constexpr std::size_t total() const { return m_total; }
+
+	constexpr bool empty() const { return m_total == 0; }
+
+	/// Chance that a card drawn at random is of rank, or 0 if there are no cards
+	constexpr double probability(Rank rank) const { return fraction(count(rank)); }
+
+	/// Chance that a card drawn at random is worth 10, or 0 if there are no cards
+	constexpr double ten_valued_probability() const { return fraction(ten_valued()); }
+
+	constexpr void add(Rank rank)
+	{
+		++m_counts[index(rank)];
+		++m_total;
+	}
+
+	/// Takes away a card of rank. There must be one.
+	constexpr void remove(Rank rank)
+	{
+		--m_counts[index(rank)];
+		--m_total;
+	}
+
+	constexpr bool operator==(const RankCounts&) const = default;
+
+private:
+	static constexpr std::size_t index(Rank rank) { return static_cast<std::size_t>(rank); }
+
+	constexpr double fraction(std::size_t cards) const
+	{
+		return m_total == 0 ? 0.0 : static_cast<double>(cards) / static_cast<double>(m_total);
+	}
+
+	/// Indexed by rank value; 0 and 1 are unused so a rank needs no offset
+	std::array<std::uint32_t, static_cast<std::size_t>(Rank::Ace) + 1> m_counts = {};
+	std::uint32_t m_total = 0;
+};
+
+static_assert(std::regular<RankCounts>);
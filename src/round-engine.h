@@ -0,0 +1,176 @@
+#pragma once
+
+#include "blackjack-game.h"
+#include "card.h"
+
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace CardGames::BlackJack
+{
+	/// One round played by a RoundEngine, written in place as the round is played: the state a
+	/// decision is made in while the player's turn lasts, and the outcome once the round is over.
+	/// It reads like a GameState, so a strategy written against node(), players_hand(),
+	/// dealer_hand() and legal_moves() plays both.
+	class RoundRecord
+	{
+	public:
+		GameNode node() const { return m_node; }
+		PlaySet legal_moves() const { return m_legal_moves; }
+		const PlayersHand& players_hand() const { return m_players_hand; }
+		const DealersHand& dealer_hand() const { return m_dealers_hand; }
+
+		/// Number of cards the round has taken from the front of the cards it is dealt from
+		std::size_t cards_dealt() const { return m_cards_dealt; }
+
+		bool operator==(const RoundRecord&) const = default;
+
+	private:
+		template <typename Rules>
+		friend class RoundEngine;
+
+		GameNode m_node = GameNode::Ready;
+		PlaySet m_legal_moves = {Play::Deal};
+		PlayersHand m_players_hand;
+		DealersHand m_dealers_hand;
+		std::size_t m_cards_dealt = 0;
+	};
+
+	static_assert(std::is_trivially_copyable_v<RoundRecord>);
+
+	/// Plays single rounds under Rules with the transitions of BasicGame<Rules>, on a RoundRecord
+	/// and straight from a span of cards: no history, no GameState and no allocation. A round
+	/// played from the cards of a game's deck with the same decisions reaches the same hands and
+	/// outcome as the game does.
+	template <typename Rules>
+	class RoundEngine
+	{
+	public:
+		RoundEngine() = default;
+
+		explicit RoundEngine(Rules rules)
+			: m_rules{rules}
+		{
+		}
+
+		/// Deals a round from the front of cards into record and plays it to the end, asking
+		/// decide(record) for every player decision. As with play_round(), plays outside the
+		/// record's legal_moves() are played as Stay. There must be enough cards for the round,
+		/// as a Deck must not be dealt from when empty.
+		template <typename Decide>
+		void play(std::span<const Card> cards, Decide&& decide, RoundRecord& record) const
+		{
+			using enum GameNode;
+
+			record = RoundRecord{};
+			const auto next_card = [&] { return cards[record.m_cards_dealt++]; };
+			auto& players_hand = record.m_players_hand;
+			auto& dealers_hand = record.m_dealers_hand;
+
+			players_hand.add_to_active(next_card()); // face down
+			dealers_hand.add(next_card());					 // face down
+			players_hand.add_to_active(next_card()); // face up
+			dealers_hand.add(next_card());					 // face up
+
+			if (players_hand.active_total() == 21)
+				return finish(record, GameOverPlayerWins);
+			if (dealers_hand.total() == 21)
+				return finish(record, GameOverDealerWins);
+			set_node(record, PlayersRound);
+
+			while (record.m_node == PlayersRound || record.m_node == PlayersSplitRound) {
+				auto play = decide(std::as_const(record));
+				if (!record.m_legal_moves.contains(play))
+					play = Play::Stay;
+
+				if (play == Play::Split) {
+					const bool is_aces = players_hand.active_cards()[0].rank() == Card::Rank::Ace;
+					const auto first_new_card = next_card();
+					players_hand.split(first_new_card, next_card());
+					const auto node = is_aces ? split_round_node(players_hand) : PlayersSplitRound;
+					if (is_aces && node == PlayersSplitRound)
+						players_hand.advance_to_next_incomplete();
+					set_node(record, node);
+				} else if (record.m_node == PlayersRound) {
+					if (play == Play::Hit) {
+						players_hand.add_to_active(next_card());
+						set_node(record, players_hand.active_is_busted() ? GameOverPlayerBusts : PlayersRound);
+					} else {
+						set_node(record, DealersRound);
+					}
+				} else {
+					if (play == Play::Hit)
+						players_hand.add_to_active(next_card());
+					if (play == Play::Stay || players_hand.active_is_busted()) {
+						players_hand.mark_active_complete();
+						players_hand.advance_to_next_incomplete();
+					}
+					set_node(record, split_round_node(players_hand));
+				}
+			}
+
+			if (record.m_node == DealersRound)
+				play_dealer_turn(record, next_card);
+		}
+
+		const Rules& rules() const { return m_rules; }
+
+	private:
+		/// Node after the split hands change, as in BasicGame
+		static GameNode split_round_node(const PlayersHand& players_hand)
+		{
+			if (players_hand.all_busted())
+				return GameNode::GameOverPlayerBusts;
+			if (players_hand.all_complete())
+				return GameNode::DealersRound;
+			return GameNode::PlayersSplitRound;
+		}
+
+		/// Moves record to node, with the legal moves a GameState in node would have
+		void set_node(RoundRecord& record, GameNode node) const
+		{
+			record.m_node = node;
+			record.m_legal_moves = node_plays[static_cast<std::size_t>(node)];
+			if (record.m_legal_moves.contains(Play::Split) &&
+					!record.m_players_hand.can_split(m_rules.allow_resplit_aces))
+				record.m_legal_moves.erase(Play::Split);
+		}
+
+		static void finish(RoundRecord& record, GameNode node)
+		{
+			record.m_node = node;
+			record.m_legal_moves = {};
+		}
+
+		template <typename NextCard>
+		void play_dealer_turn(RoundRecord& record, NextCard& next_card) const
+		{
+			using enum GameNode;
+
+			auto& dealers_hand = record.m_dealers_hand;
+			while (true) {
+				const auto& value = dealers_hand.value();
+				const bool must_hit =
+					value.total < 17 || (value.total == 17 && value.is_soft && m_rules.hit_soft_17);
+				if (!must_hit)
+					break;
+				dealers_hand.add(next_card());
+				if (dealers_hand.total() > 21)
+					return finish(record, GameOverDealerBusts);
+			}
+
+			const auto player_total = record.m_players_hand.active_total();
+			const auto dealer_total = dealers_hand.total();
+			if (player_total > dealer_total)
+				finish(record, GameOverPlayerWins);
+			else if (dealer_total > player_total)
+				finish(record, GameOverDealerWins);
+			else
+				finish(record, GameOverDraw);
+		}
+
+		Rules m_rules;
+	};
+} // namespace CardGames::BlackJack
@@ -0,0 +1,48 @@
+#include "shoe.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+	std::vector<Card> standard_decks(std::size_t decks)
+	{
+		const auto deck = Deck{};
+		auto cards = std::vector<Card>{};
+		cards.reserve(decks * deck.cards().size());
+		for (std::size_t i = 0; i < decks; ++i) {
+			cards.insert(cards.end(), deck.begin(), deck.end());
+		}
+		return cards;
+	}
+} // namespace
+
+Shoe::Shoe(ShoeConfig config)
+	: m_config{config}
+	, m_deck{standard_decks(config.decks)}
+{
+}
+
+std::size_t Shoe::cut_card() const
+{
+	const auto penetration = std::clamp(m_config.penetration, 0.0, 1.0);
+	const auto cut = static_cast<std::size_t>(penetration * static_cast<double>(size()));
+	return std::min(cut, size() > reserve_cards() ? size() - reserve_cards() : 0);
+}
+
+bool Shoe::needs_reshuffle() const
+{
+	if (!m_shuffled)
+		return true;
+	switch (m_config.reshuffle) {
+		case ReshufflePolicy::EveryRound: return dealt() > 0;
+		case ReshufflePolicy::CutCard: return dealt() >= cut_card();
+	}
+	return true;
+}
+
+void Shoe::shuffle(Rng& rng)
+{
+	m_deck = ::shuffle(Deck{standard_decks(m_config.decks)}, rng);
+	m_shuffled = true;
+}
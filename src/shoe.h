@@ -0,0 +1,97 @@
+#pragma once
+
+#include "deck.h"
+#include "random.h"
+
+#include <algorithm>
+#include <cstddef>
+
+/// When a shoe is gathered up and shuffled again
+enum class ReshufflePolicy {
+	EveryRound, ///< Before every round, as with a single hand-held deck
+	CutCard,		///< Once the cut card has come out
+};
+
+/// Configuration of a dealing shoe
+struct ShoeConfig {
+	std::size_t decks = 1;		///< Number of 52-card decks in the shoe
+	double penetration = 0.75; ///< Fraction of the shoe dealt before the cut card
+	ReshufflePolicy reshuffle = ReshufflePolicy::EveryRound;
+
+	bool operator==(const ShoeConfig&) const = default;
+};
+
+/// Most hard points the cards of one round of blackjack can be worth: four split hands, each
+/// ended by a hit at 21 or less and so worth at most 31, and a dealer's hand, which hits at
+/// 16 or less and so is worth at most 26
+inline constexpr std::size_t max_round_points = 4 * 31 + 26;
+
+/// Most cards one round of blackjack can take from a shoe of decks decks: as many of its
+/// smallest cards as max_round_points allows
+constexpr std::size_t max_round_cards(std::size_t decks)
+{
+	auto cards = std::size_t{0};
+	auto points_left = max_round_points;
+	for (std::size_t points = 1; points <= 10; ++points) {
+		const auto of_points = (points == 10 ? 16 : 4) * decks; // tens and faces count 10
+		const auto taken = std::min(of_points, points_left / points);
+		cards += taken;
+		points_left -= taken * points;
+	}
+	return cards;
+}
+
+static_assert(max_round_cards(1) == 32);
+
+/// A shoe of one or more decks, dealt down to a cut card and then reshuffled. A shoe must
+/// have at least one deck.
+class Shoe
+{
+public:
+
+	Shoe()
+		: Shoe(ShoeConfig{})
+	{
+	}
+
+	/// An unshuffled shoe; needs_reshuffle() is true until shuffle() is called
+	explicit Shoe(ShoeConfig config);
+
+	const ShoeConfig& config() const { return m_config; }
+
+	/// The cards not yet dealt
+	const Deck& deck() const { return m_deck; }
+
+	/// How many of each rank are left to deal
+	const RankCounts& composition() const { return m_deck.composition(); }
+
+	/// Number of cards in the full shoe
+	std::size_t size() const { return m_config.decks * 52; }
+
+	/// Number of cards dealt since the last shuffle
+	std::size_t dealt() const { return size() - m_deck.cards().size(); }
+
+	/// Cards always left behind the cut card, so a round started before it can be finished
+	std::size_t reserve_cards() const { return max_round_cards(m_config.decks); }
+
+	/// Number of cards dealt before the cut card comes out
+	std::size_t cut_card() const;
+
+	/// True if the shoe must be shuffled before the next round
+	bool needs_reshuffle() const;
+
+	/// Gathers all cards back into the shoe and shuffles them
+	void shuffle(Rng& rng);
+
+	/// Takes back what remains after dealing from a copy of deck()
+	void update(Deck remaining) { m_deck = std::move(remaining); }
+
+	bool operator==(const Shoe&) const = default;
+
+private:
+	ShoeConfig m_config;
+	Deck m_deck;
+	bool m_shuffled = false;
+};
+
+static_assert(std::regular<Shoe>);
@@ -0,0 +1,206 @@
+#include "simulation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <thread>
+
+namespace CardGames::BlackJack
+{
+
+	namespace
+	{
+		using Rank = Card::Rank;
+
+		/// Hits below the threshold, stays otherwise
+		template<int StayAt>
+		Play hit_below(const GameState& state)
+		{
+			return state.players_hand().active_total() < StayAt ? Play::Hit : Play::Stay;
+		}
+
+		Play always_stay(const GameState&)
+		{
+			return Play::Stay;
+		}
+
+		/// Simplified basic strategy for a table without doubling or surrender:
+		/// always split aces and eights, stand on soft 18+, and stand on hard 12-16
+		/// against a weak dealer upcard.
+		Play basic_strategy(const GameState& state)
+		{
+			const auto& players_hand = state.players_hand();
+			const auto& cards = players_hand.active_cards();
+			if (state.legal_moves().contains(Play::Split) &&
+					(cards[0].rank() == Rank::Ace || cards[0].rank() == Rank::Eight)) {
+				return Play::Split;
+			}
+
+			const auto value = calculate_hand_value(cards);
+			if (value.is_soft) {
+				return value.total < 18 ? Play::Hit : Play::Stay;
+			}
+
+			// The dealer's second card is the face up card
+			const auto upcard = add_em_up(std::span{state.dealer_hand().cards()}.subspan(1, 1));
+			if (value.total <= 11)
+				return Play::Hit;
+			if (value.total == 12)
+				return (upcard >= 4 && upcard <= 6) ? Play::Stay : Play::Hit;
+			if (value.total <= 16)
+				return upcard <= 6 ? Play::Stay : Play::Hit;
+			return Play::Stay;
+		}
+
+		const std::map<std::string, Strategy> s_strategies = {
+			{"basic", basic_strategy},
+			{"dealer", hit_below<17>}, // mimic the dealer: hit below 17
+			{"naive", hit_below<18>},	 // hit below 18
+			{"stay", always_stay},
+		};
+
+		bool is_players_turn(GameNode node)
+		{
+			return node == GameNode::PlayersRound || node == GameNode::PlayersSplitRound;
+		}
+
+		void tally(SimulationResult& result, GameNode node)
+		{
+			++result.outcomes[static_cast<std::size_t>(node)];
+			++result.rounds;
+		}
+
+		template <typename Rules>
+		GameNode play_game_round(BasicGame<Rules>& game, const Strategy& strategy)
+		{
+			const auto* state = &game.next(Play::Deal);
+			while (is_players_turn(state->node())) {
+				auto play = strategy(*state);
+				if (!state->legal_moves().contains(play)) {
+					play = Play::Stay;
+				}
+				state = &game.next(play);
+			}
+			return state->node();
+		}
+
+		/// Claims batches of a seeded simulation until none are left and plays each as a session
+		/// of one game, with the rules fixed at compile time
+		template <typename Rules>
+		void simulate_batches(SimulationResult& result, std::atomic<std::uint64_t>& next_batch,
+													std::uint64_t rounds, const Strategy& strategy,
+													const BlackjackConfig& config, std::uint64_t seed)
+		{
+			const auto batch_count = (rounds + simulation_batch_size - 1) / simulation_batch_size;
+			for (auto batch = next_batch++; batch < batch_count; batch = next_batch++) {
+				// Each batch plays a session of rounds on one game, dealing from one shoe
+				auto batch_config = config;
+				batch_config.seed = Rng{seed, batch}();
+				batch_config.history = {.retention = HistoryRetention::CurrentOnly};
+				auto game = BasicGame<Rules>{batch_config};
+				const auto first = batch * simulation_batch_size;
+				const auto last = std::min(rounds, first + simulation_batch_size);
+				for (auto i = first; i < last; ++i) {
+					if (i != first) {
+						game.new_round();
+					}
+					tally(result, play_game_round(game, strategy));
+				}
+			}
+		}
+
+		using SimulateBatches = void (*)(SimulationResult&, std::atomic<std::uint64_t>&,
+																		 std::uint64_t, const Strategy&, const BlackjackConfig&,
+																		 std::uint64_t);
+
+		/// simulate_batches() for each FixedRules, indexed by hit_soft_17 and allow_resplit_aces
+		constexpr SimulateBatches simulate_batches_by_rules[2][2] = {
+			{simulate_batches<FixedRules<false, false>>, simulate_batches<FixedRules<false, true>>},
+			{simulate_batches<FixedRules<true, false>>, simulate_batches<FixedRules<true, true>>},
+		};
+	} // namespace
+
+	std::string_view game_node_name(GameNode node)
+	{
+		using enum GameNode;
+		switch (node) {
+			case Ready: return "Ready";
+			case PlayersRound: return "PlayersRound";
+			case PlayersSplitRound: return "PlayersSplitRound";
+			case DealersRound: return "DealersRound";
+			case GameOverPlayerBusts: return "GameOverPlayerBusts";
+			case GameOverPlayerWins: return "GameOverPlayerWins";
+			case GameOverDealerBusts: return "GameOverDealerBusts";
+			case GameOverDealerWins: return "GameOverDealerWins";
+			case GameOverDraw: return "GameOverDraw";
+		}
+		return "Unknown";
+	}
+
+	std::optional<Strategy> get_strategy(const std::string& name)
+	{
+		auto it = s_strategies.find(name);
+		if (it != s_strategies.end()) {
+			return it->second;
+		}
+		return std::nullopt;
+	}
+
+	std::vector<std::string> get_strategy_names()
+	{
+		std::vector<std::string> names;
+		names.reserve(s_strategies.size());
+		for (const auto& [name, _] : s_strategies) {
+			names.push_back(name);
+		}
+		return names;
+	}
+
+	GameNode play_round(Game& game, const Strategy& strategy)
+	{
+		return play_game_round(game, strategy);
+	}
+
+	SimulationResult simulate(std::uint64_t rounds, const Strategy& strategy,
+														const BlackjackConfig& config)
+	{
+		return simulate(rounds, strategy, config, {.seed = Rng::from_entropy()(), .threads = 1});
+	}
+
+	SimulationResult simulate(std::uint64_t rounds, const Strategy& strategy,
+														const BlackjackConfig& config, const SimulationOptions& options)
+	{
+		const auto batch_count = (rounds + simulation_batch_size - 1) / simulation_batch_size;
+		const auto hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+		const auto thread_count = static_cast<unsigned>(
+			std::min<std::uint64_t>(options.threads ? options.threads : hardware_threads,
+															std::max<std::uint64_t>(batch_count, 1)));
+
+		auto next_batch = std::atomic<std::uint64_t>{0};
+		auto results = std::vector<SimulationResult>(thread_count);
+
+		// Tally into a local result so workers don't share cache lines while playing
+		const auto worker = [&](SimulationResult& result) {
+			auto local = SimulationResult{};
+			const auto play_batches =
+				simulate_batches_by_rules[config.hit_soft_17][config.allow_resplit_aces];
+			play_batches(local, next_batch, rounds, strategy, config, options.seed);
+			result = local;
+		};
+
+		{
+			auto workers = std::vector<std::jthread>{};
+			workers.reserve(thread_count);
+			for (auto& result : results) {
+				workers.emplace_back(worker, std::ref(result));
+			}
+		}
+
+		auto total = SimulationResult{};
+		for (const auto& result : results) {
+			total += result;
+		}
+		return total;
+	}
+
+} // namespace CardGames::BlackJack
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "blackjack-game.h"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace CardGames::BlackJack
+{
+
+	/// Human readable name of a game node
+	std::string_view game_node_name(GameNode node);
+
+	/// Automatic player: picks the next play for a state in PlayersRound or PlayersSplitRound
+	using Strategy = std::function<Game::Play(const GameState&)>;
+
+	/// Returns a named strategy, or nullopt if name not found
+	std::optional<Strategy> get_strategy(const std::string& name);
+
+	/// Returns list of available strategy names
+	std::vector<std::string> get_strategy_names();
+
+	/// Outcome tallies of a batch of simulated rounds
+	struct SimulationResult {
+		std::uint64_t rounds = 0;
+		std::array<std::uint64_t, game_node_count> outcomes{}; ///< Indexed by GameNode
+
+		std::uint64_t count(GameNode node) const { return outcomes[static_cast<std::size_t>(node)]; }
+
+		SimulationResult& operator+=(const SimulationResult& other)
+		{
+			rounds += other.rounds;
+			for (std::size_t i = 0; i < game_node_count; ++i) {
+				outcomes[i] += other.outcomes[i];
+			}
+			return *this;
+		}
+
+		bool operator==(const SimulationResult&) const = default;
+	};
+
+	/// Deals and plays the round of a game in its Ready state to completion, asking the strategy
+	/// for every player decision. Plays outside the state's legal_moves() are played as Stay, so
+	/// a strategy can never stall a round. Returns the final node.
+	GameNode play_round(Game& game, const Strategy& strategy);
+
+	/// Plays the given number of rounds on the calling thread with a randomly chosen seed
+	SimulationResult simulate(std::uint64_t rounds, const Strategy& strategy,
+														const BlackjackConfig& config = {});
+
+	/// Rounds per batch of a seeded simulation. Each batch plays its rounds as one session of a
+	/// game seeded from the master seed and the batch index.
+	inline constexpr std::uint64_t simulation_batch_size = 4096;
+
+	/// Options for a seeded, multi-threaded simulation
+	struct SimulationOptions {
+		std::uint64_t seed = 0; ///< Master seed; equal seeds give equal results
+		unsigned threads = 0;		///< Worker threads; 0 uses std::thread::hardware_concurrency()
+	};
+
+	/// Plays the given number of rounds across worker threads. Workers claim batches of
+	/// simulation_batch_size rounds and tally them into their own result, and the results are
+	/// merged once all batches are played. Since every batch is seeded independently of the
+	/// worker that plays it, the totals for a given seed do not depend on the thread count.
+	/// Games keep only their current state, whatever config.history says. The strategy is
+	/// called concurrently from all workers.
+	SimulationResult simulate(std::uint64_t rounds, const Strategy& strategy,
+														const BlackjackConfig& config, const SimulationOptions& options);
+
+} // namespace CardGames::BlackJack
@@ -0,0 +1,257 @@
+#include <card-set.h>
+#include <catch2/catch_test_macros.hpp>
+#include <shoe.h>
+#include <test-decks.h>
+
+#include <vector>
+
+using Rank = Card::Rank;
+using Suit = Card::Suit;
+
+// ============================================================================
+// Membership
+// ============================================================================
+
+SCENARIO("CardSet membership")
+{
+	GIVEN("An empty set")
+	{
+		auto set = CardSet{};
+
+		THEN("It holds nothing")
+		{
+			CHECK(set.empty());
+			CHECK(set.size() == 0);
+			CHECK(set.mask() == 0);
+			CHECK_FALSE(set.contains({Rank::Ace, Suit::Spades}));
+		}
+
+		WHEN("Inserting a card")
+		{
+			const auto inserted = set.insert({Rank::Ace, Suit::Spades});
+
+			THEN("It holds that card only")
+			{
+				CHECK(inserted);
+				CHECK(set.size() == 1);
+				CHECK(set.contains({Rank::Ace, Suit::Spades}));
+				CHECK_FALSE(set.contains({Rank::Ace, Suit::Hearts}));
+				CHECK_FALSE(set.contains({Rank::King, Suit::Spades}));
+			}
+
+			AND_WHEN("Inserting it again")
+			{
+				THEN("It reports the duplicate and is unchanged")
+				{
+					CHECK_FALSE(set.insert({Rank::Ace, Suit::Spades}));
+					CHECK(set.size() == 1);
+				}
+			}
+
+			AND_WHEN("Erasing it")
+			{
+				THEN("The set is empty again")
+				{
+					CHECK(set.erase({Rank::Ace, Suit::Spades}));
+					CHECK(set.empty());
+					CHECK_FALSE(set.erase({Rank::Ace, Suit::Spades}));
+				}
+			}
+		}
+	}
+
+	GIVEN("Every card inserted one at a time")
+	{
+		auto set = CardSet{};
+		auto all_new = true;
+		for (const auto& card : Deck{})
+			all_new = set.insert(card) && all_new;
+
+		THEN("Each is new, and together they are the full deck")
+		{
+			CHECK(all_new);
+			CHECK(set.size() == 52);
+			CHECK(set == CardSet::full_deck());
+			for (const auto& card : Deck{})
+				CHECK(set.contains(card));
+		}
+	}
+
+	GIVEN("A set built from cards with a repeat")
+	{
+		const auto cards = std::vector<Card>{
+			{Rank::Two, Suit::Clubs}, {Rank::Ten, Suit::Hearts}, {Rank::Two, Suit::Clubs}};
+		const auto set = CardSet{cards};
+
+		THEN("The repeat is held once")
+		{
+			CHECK(set.size() == 2);
+			CHECK(set == CardSet{{Rank::Ten, Suit::Hearts}, {Rank::Two, Suit::Clubs}});
+		}
+	}
+}
+
+// ============================================================================
+// Rank and suit masks
+// ============================================================================
+
+SCENARIO("CardSet rank and suit masks")
+{
+	GIVEN("The set of each rank and of each suit")
+	{
+		THEN("A rank holds its four cards")
+		{
+			for (const auto rank : Card::ranks()) {
+				const auto set = CardSet::of_rank(rank);
+				CHECK(set.size() == 4);
+				for (const auto suit : Card::suits())
+					CHECK(set.contains({rank, suit}));
+			}
+		}
+
+		THEN("A suit holds its thirteen cards")
+		{
+			for (const auto suit : Card::suits()) {
+				const auto set = CardSet::of_suit(suit);
+				CHECK(set.size() == 13);
+				for (const auto rank : Card::ranks())
+					CHECK(set.contains({rank, suit}));
+			}
+		}
+
+		THEN("A rank and a suit meet in exactly one card")
+		{
+			const auto card = CardSet::of_rank(Rank::Queen) & CardSet::of_suit(Suit::Diamonds);
+			CHECK(card == CardSet{{Rank::Queen, Suit::Diamonds}});
+		}
+
+		THEN("The suits partition the full deck")
+		{
+			auto all = CardSet{};
+			for (const auto suit : Card::suits()) {
+				CHECK((all & CardSet::of_suit(suit)).empty());
+				all |= CardSet::of_suit(suit);
+			}
+			CHECK(all == CardSet::full_deck());
+		}
+	}
+}
+
+// ============================================================================
+// Set algebra
+// ============================================================================
+
+SCENARIO("CardSet set algebra")
+{
+	GIVEN("The aces and the spades")
+	{
+		const auto aces = CardSet::of_rank(Rank::Ace);
+		const auto spades = CardSet::of_suit(Suit::Spades);
+
+		THEN("Union, intersection, difference and symmetric difference count as expected")
+		{
+			CHECK((aces | spades).size() == 16);
+			CHECK((aces & spades).size() == 1);
+			CHECK((aces - spades).size() == 3);
+			CHECK((aces ^ spades).size() == 15);
+			CHECK_FALSE((aces - spades).contains({Rank::Ace, Suit::Spades}));
+		}
+
+		THEN("Each is a subset of their union but not of each other")
+		{
+			CHECK(aces.is_subset_of(aces | spades));
+			CHECK(spades.is_subset_of(CardSet::full_deck()));
+			CHECK_FALSE(aces.is_subset_of(spades));
+		}
+
+		THEN("The full deck less the aces holds the other 48 cards")
+		{
+			const auto rest = CardSet::full_deck() - aces;
+			CHECK(rest.size() == 48);
+			CHECK((rest | aces) == CardSet::full_deck());
+		}
+	}
+}
+
+// ============================================================================
+// Iteration
+// ============================================================================
+
+SCENARIO("Iterating a CardSet")
+{
+	GIVEN("A set of cards from several suits")
+	{
+		const auto set = CardSet{
+			{Rank::Ace, Suit::Spades}, {Rank::Two, Suit::Clubs}, {Rank::King, Suit::Clubs},
+			{Rank::Five, Suit::Hearts}};
+
+		THEN("Its cards come suit by suit, each suit from Two up")
+		{
+			const auto cards = std::vector<Card>(set.begin(), set.end());
+			const auto expected = std::vector<Card>{{Rank::Two, Suit::Clubs},
+																							{Rank::King, Suit::Clubs},
+																							{Rank::Five, Suit::Hearts},
+																							{Rank::Ace, Suit::Spades}};
+			CHECK(cards == expected);
+		}
+	}
+
+	GIVEN("The full deck")
+	{
+		THEN("Iterating it rebuilds the same set")
+		{
+			auto copy = CardSet{};
+			auto count = 0;
+			for (const auto card : CardSet::full_deck()) {
+				copy.insert(card);
+				++count;
+			}
+			CHECK(count == 52);
+			CHECK(copy == CardSet::full_deck());
+		}
+	}
+}
+
+// ============================================================================
+// No duplicates or missing cards
+// ============================================================================
+
+SCENARIO("Decks and shoes have no duplicate or missing cards")
+{
+	GIVEN("Every named test deck")
+	{
+		THEN("None deals the same card twice")
+		{
+			for (const auto& name : CardGames::BlackJack::get_test_deck_names()) {
+				const auto deck = CardGames::BlackJack::get_test_deck(name);
+				REQUIRE(deck.has_value());
+				INFO(name);
+				CHECK(CardSet{deck->cards()}.size() == deck->cards().size());
+			}
+		}
+	}
+
+	GIVEN("Shoes of one to eight decks")
+	{
+		THEN("Each holds every card once per deck")
+		{
+			for (std::size_t decks = 1; decks <= 8; ++decks) {
+				const auto shoe = Shoe{{.decks = decks}};
+				CHECK(is_full_decks(shoe.deck().cards(), decks));
+				CHECK_FALSE(is_full_decks(shoe.deck().cards(), decks + 1));
+			}
+		}
+	}
+
+	GIVEN("Two decks where one card replaces another")
+	{
+		const auto shoe = Shoe{{.decks = 2}};
+		auto cards = std::vector<Card>(shoe.deck().begin(), shoe.deck().end());
+		cards[0] = cards[1];
+
+		THEN("They are not two full decks")
+		{
+			CHECK_FALSE(is_full_decks(cards, 2));
+		}
+	}
+}
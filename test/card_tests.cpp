@@ -598,3 +598,78 @@ SCENARIO("Card satisfies regular type properties at runtime")
 		}
 	}
 }
+
+// ============================================================================
+// Packed encoding
+// ============================================================================
+
+SCENARIO("Cards are packed into a single byte")
+{
+	THEN("A card is one byte")
+	{
+		STATIC_REQUIRE(sizeof(Card) == 1);
+	}
+
+	THEN("Construction and accessors work at compile time")
+	{
+		constexpr auto card = Card{Rank::Ace, Suit::Spades};
+		STATIC_REQUIRE(card.rank() == Rank::Ace);
+		STATIC_REQUIRE(card.suit() == Suit::Spades);
+		STATIC_REQUIRE(Card{Suit::Hearts, Rank::Two} < card);
+	}
+
+	THEN("Every rank and suit survives packing")
+	{
+		auto mismatches = 0;
+		for (const auto suit : Card::suits()) {
+			for (const auto rank : Card::ranks()) {
+				const auto card = Card{rank, suit};
+				if (card.rank() != rank || card.suit() != suit)
+					++mismatches;
+			}
+		}
+		CHECK(mismatches == 0);
+	}
+
+	THEN("A default card has the same rank and suit as before packing")
+	{
+		CHECK(Card{}.suit() == Suit::Clubs);
+		CHECK(static_cast<int>(Card{}.rank()) == 0);
+	}
+
+	THEN("Ordering still ignores the suit")
+	{
+		CHECK((Card{Rank::King, Suit::Clubs} <=> Card{Rank::King, Suit::Spades}) ==
+					std::strong_ordering::equal);
+		CHECK(Card{Rank::King, Suit::Spades} < Card{Rank::Ace, Suit::Clubs});
+	}
+}
+
+// ============================================================================
+// Compile-time suit and rank constants
+// ============================================================================
+
+SCENARIO("Suits and ranks are compile-time constants")
+{
+	THEN("The arrays are usable in constant expressions")
+	{
+		STATIC_REQUIRE(Card::all_suits.size() == 4);
+		STATIC_REQUIRE(Card::all_ranks.size() == 13);
+		STATIC_REQUIRE(Card::all_suits.front() == Suit::Clubs);
+		STATIC_REQUIRE(Card::all_ranks.back() == Rank::Ace);
+	}
+
+	THEN("suits() and ranks() return the same constants without copying them")
+	{
+		CHECK(&Card::suits() == &Card::all_suits);
+		CHECK(&Card::ranks() == &Card::all_ranks);
+	}
+
+	THEN("rank_index() gives each rank's position in all_ranks")
+	{
+		STATIC_REQUIRE(Card::rank_index(Rank::Two) == 0);
+		STATIC_REQUIRE(Card::rank_index(Rank::Ace) == 12);
+		for (std::size_t i = 0; i < Card::all_ranks.size(); ++i)
+			CHECK(Card::rank_index(Card::all_ranks[i]) == i);
+	}
+}
@@ -1,3 +1,4 @@
+#include <card-set.h>
 #include <catch2/catch_test_macros.hpp>
 #include <deck.h>
 
@@ -235,6 +236,15 @@ SCENARIO("Deck constructed from a vector of cards")
 		THEN("The deck has 0 cards")
 		{
 			CHECK(deck.cards().empty());
+			CHECK(deck.composition().empty());
+			CHECK(deck.begin() == deck.end());
+		}
+
+		THEN("It equals a moved-from deck")
+		{
+			auto full = Deck{};
+			const auto taken = std::move(full);
+			CHECK(deck == full);
 		}
 	}
 
@@ -344,23 +354,14 @@ SCENARIO("Default deck contains all 52 unique cards")
 
 		THEN("All 52 cards are distinct")
 		{
-			for (size_t i = 0; i < cards.size(); ++i) {
-				for (size_t j = i + 1; j < cards.size(); ++j) {
-					CHECK_FALSE(cards[i] == cards[j]);
-				}
-			}
+			REQUIRE(cards.size() == 52);
+			CHECK(CardSet{cards} == CardSet::full_deck());
 		}
 
 		THEN("There are 13 cards per suit")
 		{
-			for (const auto& suit : Card::suits()) {
-				int count = 0;
-				for (const auto& card : cards) {
-					if (card.suit() == suit)
-						++count;
-				}
-				CHECK(count == 13);
-			}
+			for (const auto suit : Card::suits())
+				CHECK(std::ranges::count(suits_of(cards), suit) == 13);
 		}
 	}
 }
@@ -445,6 +446,61 @@ SCENARIO("Slicing a single card")
 	}
 }
 
+// ============================================================================
+// Rank and suit views
+// ============================================================================
+
+SCENARIO("Viewing ranks and suits without copying")
+{
+	using Rank = Card::Rank;
+	using Suit = Card::Suit;
+
+	GIVEN("Some cards")
+	{
+		const auto cards = std::vector<Card>{
+			{Rank::Ace, Suit::Clubs}, {Rank::King, Suit::Hearts}, {Rank::Ace, Suit::Diamonds}};
+
+		THEN("The views read the suits and ranks in order")
+		{
+			CHECK(std::ranges::equal(suits_of(cards),
+															 std::array{Suit::Clubs, Suit::Hearts, Suit::Diamonds}));
+			CHECK(std::ranges::equal(ranks_of(cards), std::array{Rank::Ace, Rank::King, Rank::Ace}));
+			CHECK(std::ranges::size(ranks_of(cards)) == 3);
+		}
+
+		THEN("They agree with the slicing functions")
+		{
+			CHECK(std::ranges::equal(suits_of(cards), slice_suits(cards)));
+			CHECK(std::ranges::equal(ranks_of(cards), slice_face_values(cards)));
+		}
+
+		THEN("The rank histogram counts each rank at its index")
+		{
+			auto histogram = std::array<std::size_t, 13>{};
+			histogram.fill(7);
+			rank_histogram(cards, histogram);
+			CHECK(histogram[Card::rank_index(Rank::Ace)] == 2);
+			CHECK(histogram[Card::rank_index(Rank::King)] == 1);
+			CHECK(histogram[Card::rank_index(Rank::Two)] == 0);
+		}
+	}
+
+	GIVEN("A default deck")
+	{
+		const auto deck = Deck{};
+
+		THEN("Its histogram has four of each rank and matches its composition")
+		{
+			auto histogram = std::array<std::size_t, 13>{};
+			rank_histogram(deck.cards(), histogram);
+			for (const auto rank : Card::ranks()) {
+				CHECK(histogram[Card::rank_index(rank)] == 4);
+				CHECK(histogram[Card::rank_index(rank)] == deck.composition().count(rank));
+			}
+		}
+	}
+}
+
 // ============================================================================
 // Mutable iteration
 // ============================================================================
@@ -471,4 +527,255 @@ SCENARIO("Mutable deck iteration")
 			}
 		}
 	}
-}
\ No newline at end of file
+}
+// ============================================================================
+// Dealing advances a cursor over the deck's storage
+// ============================================================================
+
+SCENARIO("Dealing advances through the deck without rebuilding it")
+{
+	GIVEN("A default deck")
+	{
+		auto deck = Deck{};
+		const auto remaining = deck.cards();
+
+		WHEN("Dealing one card")
+		{
+			const auto card = deck.deal();
+
+			THEN("The remaining cards are the same storage, one card further on")
+			{
+				CHECK(card == remaining.front());
+				CHECK(deck.cards().data() == remaining.data() + 1);
+				CHECK(deck.cards().size() == 51);
+			}
+		}
+
+		WHEN("Dealing three cards at once")
+		{
+			const auto dealt = deck.deal(3);
+
+			THEN("The dealt view points into the deck's storage")
+			{
+				CHECK(dealt.data() == remaining.data());
+				CHECK(deck.cards().data() == remaining.data() + 3);
+			}
+
+			THEN("The dealt view stays valid while dealing continues")
+			{
+				const auto first = dealt[0];
+				deck.deal(10);
+				CHECK(dealt[0] == first);
+				CHECK(dealt.size() == 3);
+			}
+		}
+
+		WHEN("Dealing the whole deck card by card")
+		{
+			auto dealt = std::vector<Card>{};
+			while (!deck.cards().empty()) {
+				dealt.push_back(deck.deal());
+			}
+
+			THEN("Every card comes out once, in order")
+			{
+				CHECK(dealt.size() == 52);
+				CHECK(Deck{dealt} == Deck{});
+			}
+		}
+	}
+
+	GIVEN("Two decks with the same remaining cards but different dealt cards")
+	{
+		using Rank = Card::Rank;
+		using Suit = Card::Suit;
+
+		auto a = Deck{std::vector<Card>{{Rank::Two, Suit::Clubs}, {Rank::Ace, Suit::Spades}}};
+		auto b = Deck{std::vector<Card>{{Rank::Three, Suit::Hearts}, {Rank::Ace, Suit::Spades}}};
+		a.deal();
+		b.deal();
+
+		THEN("They are equal")
+		{
+			CHECK(a == b);
+		}
+	}
+}
+
+// ============================================================================
+// Copies share their cards until one is modified
+// ============================================================================
+
+SCENARIO("Copies of a deck share its cards")
+{
+	GIVEN("A deck and a copy of it")
+	{
+		auto deck = Deck{};
+		deck.deal(2);
+		auto copy = deck;
+
+		THEN("The copy views the same storage")
+		{
+			CHECK(copy.cards().data() == deck.cards().data());
+		}
+
+		WHEN("Dealing from the copy")
+		{
+			const auto card = copy.deal();
+
+			THEN("The original still holds that card")
+			{
+				CHECK(deck.cards().front() == card);
+				CHECK(deck.cards().size() == 50);
+				CHECK(copy.cards().size() == 49);
+			}
+		}
+
+		WHEN("Modifying the copy through its mutable iterators")
+		{
+			const auto original = std::vector<Card>(deck.cards().begin(), deck.cards().end());
+			std::reverse(copy.begin(), copy.end());
+
+			THEN("The copy has its own cards and the original is unchanged")
+			{
+				CHECK(copy.cards().data() != deck.cards().data());
+				CHECK(std::ranges::equal(deck.cards(), original));
+				CHECK(copy.cards().front() == original.back());
+				CHECK(copy.cards().size() == 50);
+			}
+		}
+	}
+
+	GIVEN("A deck that has been moved from")
+	{
+		auto deck = Deck{};
+		deck.deal(5);
+		const auto moved = std::move(deck);
+
+		THEN("It is empty and can be assigned again")
+		{
+			CHECK(deck.cards().empty());
+			deck = Deck{};
+			CHECK(deck.cards().size() == 52);
+		}
+	}
+}
+
+// ============================================================================
+// Rank composition
+// ============================================================================
+
+SCENARIO("A deck keeps count of the ranks it has left")
+{
+	using Rank = Card::Rank;
+	using Suit = Card::Suit;
+
+	GIVEN("A default deck")
+	{
+		auto deck = Deck{};
+
+		THEN("It holds four of each rank and sixteen cards worth ten")
+		{
+			for (const auto rank : Card::ranks())
+				CHECK(deck.composition().count(rank) == 4);
+			CHECK(deck.composition().ten_valued() == 16);
+			CHECK(deck.composition().total() == 52);
+			CHECK(deck.composition().probability(Rank::Ace) == 4.0 / 52.0);
+			CHECK(deck.composition().ten_valued_probability() == 16.0 / 52.0);
+		}
+
+		WHEN("Dealing one card and then three more")
+		{
+			const auto first = deck.deal();
+			deck.deal(3);
+
+			THEN("The counts drop by the ranks dealt")
+			{
+				CHECK(first.rank() == Rank::Two);
+				CHECK(deck.composition().count(Rank::Two) == 3);
+				CHECK(deck.composition().count(Rank::Three) == 3);
+				CHECK(deck.composition().count(Rank::Five) == 3);
+				CHECK(deck.composition().count(Rank::Six) == 4);
+				CHECK(deck.composition().total() == 48);
+			}
+		}
+
+		WHEN("Asking for more cards than remain")
+		{
+			deck.deal(53);
+
+			THEN("Nothing is dealt and nothing is counted off")
+			{
+				CHECK(deck.composition().total() == 52);
+			}
+		}
+
+		WHEN("Shuffling and dealing part of it")
+		{
+			auto rng = Rng{21};
+			deck = shuffle(deck, rng);
+			deck.deal(17);
+			deck.deal();
+
+			THEN("The counts match a recount of the remaining cards")
+			{
+				CHECK(deck.composition() == RankCounts{deck.cards()});
+				CHECK(deck.composition().total() == 34);
+			}
+		}
+
+		WHEN("Dealing every card")
+		{
+			deck.deal(52);
+
+			THEN("Nothing is left and every probability is zero")
+			{
+				CHECK(deck.composition().empty());
+				CHECK(deck.composition().probability(Rank::Ace) == 0.0);
+			}
+		}
+	}
+
+	GIVEN("A deck built from a list of cards")
+	{
+		const auto deck = Deck{std::vector<Card>{
+			{Rank::King, Suit::Hearts}, {Rank::Ace, Suit::Spades}, {Rank::King, Suit::Clubs}}};
+
+		THEN("It counts those cards")
+		{
+			CHECK(deck.composition().count(Rank::King) == 2);
+			CHECK(deck.composition().count(Rank::Ace) == 1);
+			CHECK(deck.composition().count(Rank::Two) == 0);
+			CHECK(deck.composition().ten_valued() == 2);
+		}
+	}
+
+	GIVEN("A copy of a partly dealt deck")
+	{
+		auto deck = Deck{};
+		deck.deal(10);
+		auto copy = deck;
+
+		WHEN("Dealing from the copy")
+		{
+			copy.deal(5);
+
+			THEN("Only the copy's counts change")
+			{
+				CHECK(deck.composition().total() == 42);
+				CHECK(copy.composition().total() == 37);
+			}
+		}
+
+		WHEN("Moving from it")
+		{
+			const auto moved = std::move(copy);
+
+			THEN("The counts move too")
+			{
+				CHECK(moved.composition() == deck.composition());
+				CHECK(copy.composition().empty());
+			}
+		}
+	}
+}
@@ -1,6 +1,8 @@
 #include <blackjack-game.h>
 #include <catch2/catch_test_macros.hpp>
 
+#include <type_traits>
+
 using namespace CardGames::BlackJack;
 
 SCENARIO("Game states")
@@ -14,7 +16,12 @@ SCENARIO("Game states")
 			CHECK(gs.node() == GameNode::Ready);
 			CHECK(gs.players_hand().active_cards().empty());
 			CHECK(gs.dealer_hand().cards().empty());
-			CHECK(gs.deck().cards().size() == 52);
+		}
+
+		THEN("It has no deck until it is given one, so building it never shuffles")
+		{
+			CHECK(gs.deck().cards().empty());
+			CHECK(gs == GameState{});
 		}
 
 		GIVEN("A default Game")
@@ -27,7 +34,7 @@ SCENARIO("Game states")
 				CHECK(gs.node() == GameNode::Ready);
 				CHECK(gs.players_hand().active_cards().empty());
 				CHECK(gs.dealer_hand().cards().empty());
-				CHECK(gs.deck().cards().size() == 52);
+				CHECK(gs.deck().cards().empty()); // the shoe is shuffled at the first deal
 			}
 
 			WHEN("Dealing the first round")
@@ -1380,4 +1387,576 @@ SCENARIO("PlayersHand value calculation with soft ace")
 			CHECK(hand.active_total() == 12);
 		}
 	}
-}
\ No newline at end of file
+}
+// ============================================================================
+// Seeded games
+// ============================================================================
+
+SCENARIO("Seeded games are reproducible")
+{
+	GIVEN("Two games with the same seed")
+	{
+		auto a = Game{{.seed = 2024}};
+		auto b = Game{{.seed = 2024}};
+
+		THEN("They start from the same state")
+		{
+			CHECK(a.state() == b.state());
+		}
+
+		WHEN("Dealing both")
+		{
+			const auto& sa = a.next(Game::Play::Deal);
+			const auto& sb = b.next(Game::Play::Deal);
+
+			THEN("The same cards are dealt")
+			{
+				CHECK(sa == sb);
+			}
+		}
+	}
+
+	GIVEN("A GameState built from a seeded engine")
+	{
+		auto rng = Rng{2024};
+		const auto gs = GameState{rng};
+
+		THEN("It is a Ready state with the full deck a game with that seed shuffles")
+		{
+			CHECK(gs.node() == GameNode::Ready);
+			CHECK(gs.deck().cards().size() == 52);
+			auto game = Game{{.seed = 2024}};
+			auto deck = gs.deck();
+			deck.deal(4);
+			CHECK(game.next(Game::Play::Deal).deck() == deck);
+		}
+	}
+}
+
+SCENARIO("A game shuffles its shoe at the first deal")
+{
+	GIVEN("An unseeded default game")
+	{
+		auto game = Game{};
+
+		THEN("Its new shoe is not shuffled yet, and the Ready state holds no deck")
+		{
+			CHECK(game.shoe() == Shoe{});
+			CHECK(game.shoe().needs_reshuffle());
+			CHECK(game.state().deck().cards().empty());
+		}
+
+		WHEN("Starting a new round before dealing")
+		{
+			game.new_round();
+
+			THEN("The shoe is still not shuffled")
+			{
+				CHECK(game.shoe() == Shoe{});
+				CHECK(game.state().deck().cards().empty());
+			}
+		}
+
+		WHEN("Dealing")
+		{
+			const auto& state = game.next(Game::Play::Deal);
+
+			THEN("The shoe is shuffled and the round dealt from it")
+			{
+				CHECK(game.shoe().deck() == state.deck());
+				CHECK(game.shoe().dealt() == 4);
+				CHECK(state.deck().cards().size() == 48);
+			}
+		}
+	}
+
+	GIVEN("A shuffled shoe")
+	{
+		auto rng = Rng{5};
+		auto shoe = Shoe{};
+		shoe.shuffle(rng);
+
+		WHEN("An unseeded game continues from it")
+		{
+			const auto game = Game{{}, shoe};
+
+			THEN("It deals from the shoe as it is")
+			{
+				CHECK(game.state().deck() == shoe.deck());
+				CHECK(game.shoe() == shoe);
+			}
+		}
+	}
+
+	GIVEN("An unseeded game dealt from an initial deck")
+	{
+		const auto initial_deck = Deck{std::vector<Card>{{Card::Rank::Ace, Card::Suit::Spades}}};
+		const auto game = Game{{.initial_deck = initial_deck}};
+
+		THEN("It has no shoe of its own to shuffle")
+		{
+			CHECK(game.state().deck() == initial_deck);
+			CHECK(game.shoe() == Shoe{});
+			CHECK(game.shoe().needs_reshuffle());
+		}
+	}
+}
+
+// ============================================================================
+// Incremental hand values
+// ============================================================================
+
+SCENARIO("Hands keep their value up to date as cards are added")
+{
+	using Rank = Card::Rank;
+	using Suit = Card::Suit;
+
+	GIVEN("Every hand of up to four cards")
+	{
+		THEN("Adding cards one at a time gives the same value as calculating it from scratch")
+		{
+			auto mismatches = 0;
+			auto hand = std::vector<Card>{};
+			const auto check_prefixes = [&](const auto& self, HandValue value) -> void {
+				if (value != calculate_hand_value(hand))
+					++mismatches;
+				if (hand.size() == 4)
+					return;
+				for (const auto rank : Card::ranks()) {
+					const auto card = Card{rank, Suit::Spades};
+					hand.push_back(card);
+					self(self, add_card(value, card));
+					hand.pop_back();
+				}
+			};
+			check_prefixes(check_prefixes, HandValue{});
+			CHECK(mismatches == 0);
+		}
+	}
+
+	GIVEN("Long hands dealt from a shuffled eight-deck shoe")
+	{
+		auto rng = Rng{77};
+		auto shoe = Shoe{{.decks = 8}};
+		shoe.shuffle(rng);
+		auto deck = shoe.deck();
+
+		THEN("The incremental value matches after every card")
+		{
+			auto mismatches = 0;
+			while (deck.cards().size() >= 12) {
+				auto dealer = DealersHand{};
+				auto player = PlayersHand{std::vector<Card>{}};
+				for (int i = 0; i < 12; ++i) {
+					const auto card = deck.deal();
+					dealer.add(card);
+					player.add_to_active(card);
+					if (dealer.value() != calculate_hand_value(dealer.cards()) ||
+							player.active_value() != calculate_hand_value(player.active_cards()))
+						++mismatches;
+				}
+			}
+			CHECK(mismatches == 0);
+		}
+	}
+
+	GIVEN("A pair of aces with a soft total")
+	{
+		auto hand =
+			PlayersHand{std::vector<Card>{{Rank::Ace, Suit::Clubs}, {Rank::Ace, Suit::Hearts}}};
+
+		THEN("It is a soft 12")
+		{
+			CHECK(hand.active_value() == HandValue{12, true, 1});
+		}
+
+		WHEN("Splitting it")
+		{
+			hand.split({Rank::Nine, Suit::Spades}, {Rank::King, Suit::Diamonds});
+
+			THEN("Each hand has the value of its own cards")
+			{
+				REQUIRE(hand.hand_count() == 2);
+				CHECK(hand.all_hands()[0].value == HandValue{20, true, 1});
+				CHECK(hand.all_hands()[1].value == HandValue{21, true, 1});
+			}
+		}
+	}
+
+	GIVEN("A dealer hand built from cards")
+	{
+		auto dealer =
+			DealersHand{std::vector<Card>{{Rank::Ace, Suit::Clubs}, {Rank::Ten, Suit::Hearts}}};
+
+		WHEN("Adding an ace")
+		{
+			dealer.add({Rank::Ace, Suit::Spades});
+
+			THEN("Both aces count as 1")
+			{
+				CHECK(dealer.value() == HandValue{12, false, 0});
+				CHECK_FALSE(dealer.is_soft());
+			}
+		}
+	}
+}
+
+// ============================================================================
+// Hands hold their cards inline
+// ============================================================================
+
+SCENARIO("Hands hold up to the most cards a hand can take")
+{
+	using Rank = Card::Rank;
+	using Suit = Card::Suit;
+
+	THEN("Hands are trivially copyable")
+	{
+		STATIC_REQUIRE(std::is_trivially_copyable_v<DealersHand>);
+		STATIC_REQUIRE(std::is_trivially_copyable_v<PlayersHand::SingleHand>);
+		STATIC_REQUIRE(std::is_trivially_copyable_v<PlayersHand>);
+	}
+
+	GIVEN("A game dealing from a shoe of nothing but aces")
+	{
+		auto game = Game{{.initial_deck = Deck{std::vector<Card>(40, {Rank::Ace, Suit::Spades})}}};
+		game.next(Game::Play::Deal);
+
+		WHEN("The player hits until the hand ends")
+		{
+			while (game.state().node() == GameNode::PlayersRound)
+				game.next(Game::Play::Hit);
+
+			THEN("The longest possible hand busts with max_hand_cards cards")
+			{
+				CHECK(game.state().node() == GameNode::GameOverPlayerBusts);
+				CHECK(game.state().players_hand().active_cards().size() == max_hand_cards);
+				CHECK(game.state().players_hand().active_total() == 22);
+			}
+		}
+	}
+}
+
+// ============================================================================
+// Split hands are bounded
+// ============================================================================
+
+SCENARIO("A player holds at most four hands")
+{
+	using Rank = Card::Rank;
+	using Suit = Card::Suit;
+
+	GIVEN("A pair of eights split three times, always on the first hand")
+	{
+		const auto eight = Card{Rank::Eight, Suit::Clubs};
+		auto hand = PlayersHand{std::vector<Card>{eight, eight}};
+		for (int split = 0; split < 3; ++split) {
+			REQUIRE(hand.can_split());
+			hand.split(eight, eight);
+		}
+
+		THEN("There are four hands, each a pair of eights, in play order")
+		{
+			REQUIRE(hand.hand_count() == PlayersHand::max_hands);
+			for (const auto& single : hand.all_hands()) {
+				CHECK(single.cards.size() == 2);
+				CHECK(single.value.total == 16);
+			}
+			CHECK(hand.all_hands()[0].split_count == 3);
+			CHECK(hand.all_hands()[1].split_count == 3);
+			CHECK(hand.all_hands()[2].split_count == 2);
+			CHECK(hand.all_hands()[3].split_count == 1);
+		}
+
+		WHEN("Moving on to a hand that has split fewer than three times")
+		{
+			hand.mark_active_complete();
+			hand.advance_to_next_incomplete();
+			hand.mark_active_complete();
+			hand.advance_to_next_incomplete();
+
+			THEN("It cannot split, because there is no room for a fifth hand")
+			{
+				REQUIRE(hand.active_index() == 2);
+				CHECK(hand.all_hands()[2].split_count == 2);
+				CHECK_FALSE(hand.can_split());
+			}
+		}
+	}
+}
+
+// ============================================================================
+// Rules fixed at compile time
+// ============================================================================
+
+SCENARIO("Games with fixed rules play as games configured with the same rules")
+{
+	using Rank = Card::Rank;
+	using Suit = Card::Suit;
+
+	THEN("Fixed rules are compile-time constants taking no space")
+	{
+		STATIC_REQUIRE(FixedRules<true, false>::hit_soft_17);
+		STATIC_REQUIRE_FALSE(FixedRules<true, false>::allow_resplit_aces);
+		STATIC_REQUIRE(std::is_empty_v<FixedRules<false, true>>);
+		STATIC_REQUIRE(std::is_same_v<Game, BasicGame<ConfiguredRules>>);
+	}
+
+	THEN("apply() sets a config's rule fields to the fixed rules and keeps the rest")
+	{
+		const auto config = FixedRules<false, true>::apply({.seed = 3});
+		CHECK_FALSE(config.hit_soft_17);
+		CHECK(config.allow_resplit_aces);
+		CHECK(config.seed == 3u);
+		CHECK(config.shoe == ShoeConfig{});
+	}
+
+	GIVEN("A deal giving the player 18 and the dealer a soft 17, then a Two")
+	{
+		const auto deck = Deck{std::vector<Card>{{Rank::Ten, Suit::Clubs},
+																						 {Rank::Ace, Suit::Hearts},
+																						 {Rank::Eight, Suit::Clubs},
+																						 {Rank::Six, Suit::Hearts},
+																						 {Rank::Two, Suit::Spades}}};
+
+		WHEN("The dealer hits soft 17")
+		{
+			auto fixed = BasicGame<FixedRules<true, false>>{{.initial_deck = deck}};
+			auto configured = Game{{.hit_soft_17 = true, .initial_deck = deck}};
+			fixed.next(Play::Deal);
+			configured.next(Play::Deal);
+
+			THEN("The dealer draws to a soft 19 and wins either way")
+			{
+				CHECK(fixed.next(Play::Stay).node() == GameNode::GameOverDealerWins);
+				CHECK(fixed.state().dealer_hand().total() == 19);
+				CHECK(configured.next(Play::Stay) == fixed.state());
+			}
+		}
+
+		WHEN("The dealer stands on soft 17")
+		{
+			auto fixed = BasicGame<FixedRules<false, false>>{
+				FixedRules<false, false>::apply({.initial_deck = deck})};
+			auto configured = Game{{.hit_soft_17 = false, .initial_deck = deck}};
+			fixed.next(Play::Deal);
+			configured.next(Play::Deal);
+
+			THEN("The player wins either way")
+			{
+				CHECK(fixed.next(Play::Stay).node() == GameNode::GameOverPlayerWins);
+				CHECK(fixed.state().dealer_hand().total() == 17);
+				CHECK(configured.next(Play::Stay) == fixed.state());
+			}
+		}
+	}
+
+	GIVEN("Seeded sessions from a six-deck shoe under each rule set")
+	{
+		// Splits whenever it can, so resplitting aces comes up, and otherwise hits below 17
+		const auto play_session = [](auto& game) {
+			auto states = std::vector<GameState>{};
+			for (int round = 0; round < 300; ++round) {
+				if (round != 0)
+					game.new_round();
+				auto state = game.next(Play::Deal);
+				states.push_back(state);
+				while (state.node() == GameNode::PlayersRound ||
+							 state.node() == GameNode::PlayersSplitRound) {
+					if (state.can_split(game.rules().allow_resplit_aces))
+						state = game.next(Play::Split);
+					else
+						state = game.next(state.players_hand().active_total() < 17 ? Play::Hit : Play::Stay);
+					states.push_back(state);
+				}
+			}
+			return states;
+		};
+
+		const auto same_play = [&]<bool HitSoft17, bool AllowResplitAces>() {
+			const auto config = BlackjackConfig{
+				.hit_soft_17 = HitSoft17,
+				.allow_resplit_aces = AllowResplitAces,
+				.seed = 77,
+				.shoe = {.decks = 6, .reshuffle = ReshufflePolicy::CutCard},
+			};
+			auto fixed = BasicGame<FixedRules<HitSoft17, AllowResplitAces>>{config};
+			auto configured = Game{config};
+			return play_session(fixed) == play_session(configured);
+		};
+
+		THEN("Every state matches the configured game's")
+		{
+			CHECK(same_play.operator()<false, false>());
+			CHECK(same_play.operator()<false, true>());
+			CHECK(same_play.operator()<true, false>());
+			CHECK(same_play.operator()<true, true>());
+		}
+	}
+}
+
+// ============================================================================
+// Transition table
+// ============================================================================
+
+SCENARIO("Each node accepts the plays of the state diagram")
+{
+	GIVEN("A set of plays")
+	{
+		auto plays = PlaySet{Play::Hit, Play::Stay};
+
+		THEN("It holds one bit per play")
+		{
+			CHECK(plays.contains(Play::Hit));
+			CHECK_FALSE(plays.contains(Play::Split));
+			CHECK(plays.mask() == 0b0110);
+			CHECK((plays | PlaySet{Play::Split}) == PlaySet{Play::Hit, Play::Stay, Play::Split});
+		}
+
+		WHEN("Inserting and erasing plays")
+		{
+			plays.insert(Play::Split);
+			plays.erase(Play::Hit);
+			plays.erase(Play::Stay);
+
+			THEN("Only the inserted play is left")
+			{
+				CHECK(plays == PlaySet{Play::Split});
+				plays.erase(Play::Split);
+				CHECK(plays.empty());
+			}
+		}
+	}
+
+	THEN("Ready deals, the player's rounds hit, stay and split, and no other node takes a play")
+	{
+		using enum GameNode;
+		constexpr auto players_plays = PlaySet{Play::Hit, Play::Stay, Play::Split};
+		STATIC_REQUIRE(node_plays[static_cast<std::size_t>(Ready)] == PlaySet{Play::Deal});
+		STATIC_REQUIRE(node_plays[static_cast<std::size_t>(PlayersRound)] == players_plays);
+		STATIC_REQUIRE(node_plays[static_cast<std::size_t>(PlayersSplitRound)] == players_plays);
+		for (const auto node : {DealersRound, GameOverPlayerBusts, GameOverPlayerWins,
+														GameOverDealerBusts, GameOverDealerWins, GameOverDraw}) {
+			CHECK(node_plays[static_cast<std::size_t>(node)].empty());
+		}
+	}
+
+	GIVEN("Seeded rounds played to the end, splitting whenever possible")
+	{
+		auto game = Game{{.seed = 5, .shoe = {.decks = 6, .reshuffle = ReshufflePolicy::CutCard}}};
+
+		THEN("Every play outside a state's legal moves leaves the game as it is")
+		{
+			const auto all_plays = {Play::Deal, Play::Hit, Play::Stay, Play::Split};
+			const auto refuses_others = [&] {
+				const auto state = game.state();
+				const auto states = game.history().size();
+				const auto node_allows = node_plays[static_cast<std::size_t>(state.node())];
+				if ((state.legal_moves() | node_allows) != node_allows)
+					return false;
+				for (const auto play : all_plays) {
+					if (state.legal_moves().contains(play))
+						continue;
+					if (game.next(play) != state || game.history().size() != states)
+						return false;
+				}
+				return true;
+			};
+
+			for (int round = 0; round < 200; ++round) {
+				if (round != 0)
+					game.new_round();
+				REQUIRE(refuses_others());
+				game.next(Play::Deal);
+				REQUIRE(refuses_others());
+				while (game.state().node() == GameNode::PlayersRound ||
+							 game.state().node() == GameNode::PlayersSplitRound) {
+					const auto& state = game.state();
+					if (state.legal_moves().contains(Play::Split))
+						game.next(Play::Split);
+					else
+						game.next(state.players_hand().active_total() < 15 ? Play::Hit : Play::Stay);
+					REQUIRE(refuses_others());
+				}
+			}
+		}
+	}
+}
+
+// ============================================================================
+// Legal moves
+// ============================================================================
+
+SCENARIO("A state knows its legal moves")
+{
+	using Rank = Card::Rank;
+	using Suit = Card::Suit;
+
+	GIVEN("A new game")
+	{
+		const auto game = Game{};
+
+		THEN("It can only deal")
+		{
+			CHECK(GameState{}.legal_moves() == PlaySet{Play::Deal});
+			CHECK(game.state().legal_moves() == PlaySet{Play::Deal});
+		}
+	}
+
+	GIVEN("A deal of a pair of eights against a dealer's 16")
+	{
+		auto game = Game{{.initial_deck = Deck{std::vector<Card>{{Rank::Eight, Suit::Clubs},
+																														{Rank::Nine, Suit::Clubs},
+																														{Rank::Eight, Suit::Hearts},
+																														{Rank::Seven, Suit::Clubs},
+																														{Rank::Two, Suit::Clubs},
+																														{Rank::Three, Suit::Clubs},
+																														{Rank::Ten, Suit::Clubs},
+																														{Rank::Ten, Suit::Hearts}}}}};
+		const auto& dealt = game.next(Play::Deal);
+
+		THEN("The player can hit, stay or split")
+		{
+			REQUIRE(dealt.node() == GameNode::PlayersRound);
+			CHECK(dealt.legal_moves() == PlaySet{Play::Hit, Play::Stay, Play::Split});
+		}
+
+		WHEN("Splitting them")
+		{
+			const auto& split = game.next(Play::Split);
+
+			THEN("The first split hand, eight and two, can hit or stay but not split")
+			{
+				REQUIRE(split.node() == GameNode::PlayersSplitRound);
+				CHECK(split.legal_moves() == PlaySet{Play::Hit, Play::Stay});
+			}
+
+			AND_WHEN("Standing on both hands")
+			{
+				game.next(Play::Stay);
+				const auto& over = game.next(Play::Stay);
+
+				THEN("The round is over and no play is legal")
+				{
+					CHECK(over.node() == GameNode::GameOverDealerBusts);
+					CHECK(over.legal_moves().empty());
+				}
+			}
+		}
+	}
+
+	GIVEN("A player's turn on a pair of aces from a split of aces")
+	{
+		const auto ace = Card{Rank::Ace, Suit::Spades};
+		auto hand = PlayersHand{std::vector<Card>{ace, ace}};
+		hand.split(ace, ace);
+
+		THEN("Split is legal only if aces may be resplit")
+		{
+			const auto nrsa = GameState{GameNode::PlayersSplitRound, hand, DealersHand{}, Deck{}};
+			const auto rsa = GameState{GameNode::PlayersSplitRound, hand, DealersHand{}, Deck{}, true};
+			CHECK(nrsa.legal_moves() == PlaySet{Play::Hit, Play::Stay});
+			CHECK(rsa.legal_moves() == PlaySet{Play::Hit, Play::Stay, Play::Split});
+		}
+	}
+}
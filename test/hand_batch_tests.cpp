@@ -0,0 +1,403 @@
+#include <blackjack-game.h>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <hand-batch.h>
+
+#include <algorithm>
+#include <span>
+#include <utility>
+#include <vector>
+
+using namespace CardGames::BlackJack;
+
+namespace
+{
+	/// Hands of one to max_size cards dealt from shuffled eight-deck shoes
+	std::vector<std::vector<Card>> dealt_hands(std::size_t count, std::size_t max_size)
+	{
+		auto rng = Rng{99};
+		auto hands = std::vector<std::vector<Card>>{};
+		auto deck = Deck{std::vector<Card>{}};
+		for (std::size_t size = 1; hands.size() < count; size = size % max_size + 1) {
+			if (deck.cards().size() < size)
+				deck = shuffle(Shoe{{.decks = 8}}.deck(), rng);
+			const auto cards = deck.deal(size);
+			hands.emplace_back(cards.begin(), cards.end());
+		}
+		return hands;
+	}
+
+	HandBatch make_batch(const std::vector<std::vector<Card>>& hands)
+	{
+		auto batch = HandBatch{hands.size()};
+		for (std::size_t h = 0; h < hands.size(); ++h)
+			batch.assign(h, hands[h]);
+		return batch;
+	}
+
+	/// Dealer's two cards followed by the cards the dealer would draw, dealt from shuffled
+	/// eight-deck shoes
+	std::vector<std::vector<Card>> dealer_deals(std::size_t count)
+	{
+		constexpr auto deal_size = 2 + DealerBatch::max_draws;
+		auto rng = Rng{17};
+		auto deals = std::vector<std::vector<Card>>{};
+		auto deck = Deck{std::vector<Card>{}};
+		while (deals.size() < count) {
+			if (deck.cards().size() < deal_size)
+				deck = shuffle(Shoe{{.decks = 8}}.deck(), rng);
+			const auto cards = deck.deal(deal_size);
+			deals.emplace_back(cards.begin(), cards.end());
+		}
+		return deals;
+	}
+
+	/// A batch in which the dealer of every round but each seventh plays from the first two
+	/// cards of its deal, drawing from the rest
+	DealerBatch make_dealer_batch(const std::vector<std::vector<Card>>& deals)
+	{
+		auto batch = DealerBatch{deals.size()};
+		for (std::size_t r = 0; r < deals.size(); ++r) {
+			const auto cards = std::span<const Card>{deals[r]};
+			batch.assign(r, calculate_hand_value(cards.first(2)), cards.subspan(2));
+			if (r % 7 == 6)
+				batch.skip(r);
+		}
+		return batch;
+	}
+
+	/// The dealer's final value and the number of cards drawn, as the game plays the dealer's
+	/// turn from the first two cards
+	std::pair<HandValue, std::size_t> dealer_turn(std::span<const Card> cards, bool hit_soft_17)
+	{
+		auto hand = DealersHand{cards.first(2)};
+		auto dealt = std::size_t{2};
+		while (hand.total() < 17 || (hand.total() == 17 && hand.is_soft() && hit_soft_17))
+			hand.add(cards[dealt++]);
+		return {hand.value(), dealt - 2};
+	}
+
+	/// Number of rounds whose dealer ends differently from dealer_turn(). Dealers that don't
+	/// play must keep their starting value and draw nothing.
+	int mismatches(const std::vector<std::vector<Card>>& deals, bool hit_soft_17,
+								 const DealerTurns& turns)
+	{
+		auto count = 0;
+		for (std::size_t r = 0; r < deals.size(); ++r) {
+			const auto cards = std::span<const Card>{deals[r]};
+			const auto skipped = std::pair{calculate_hand_value(cards.first(2)), std::size_t{0}};
+			const auto expected = r % 7 != 6 ? dealer_turn(cards, hit_soft_17) : skipped;
+			if (turns[r] != expected.first || turns.draws[r] != expected.second)
+				++count;
+		}
+		return count;
+	}
+
+	/// Number of hands whose batch value differs from calculate_hand_value()
+	int mismatches(const std::vector<std::vector<Card>>& hands, const HandBatchValues& values)
+	{
+		auto count = 0;
+		for (std::size_t h = 0; h < hands.size(); ++h) {
+			if (values[h] != calculate_hand_value(hands[h]))
+				++count;
+		}
+		return count;
+	}
+} // namespace
+
+// ============================================================================
+// Layout
+// ============================================================================
+
+SCENARIO("HandBatch layout")
+{
+	using Rank = Card::Rank;
+	using Suit = Card::Suit;
+
+	GIVEN("A batch of three hands")
+	{
+		auto batch = HandBatch{3};
+
+		THEN("It is padded to a whole number of vectors")
+		{
+			CHECK(batch.size() == 3);
+			CHECK(batch.stride() == HandBatch::lanes);
+			CHECK(batch.max_hand_size() == 0);
+		}
+
+		WHEN("Adding cards to the second hand")
+		{
+			batch.add(1, {Rank::King, Suit::Clubs});
+			batch.add(1, {Rank::Ace, Suit::Hearts});
+
+			THEN("Each card lands in its slot at the hand's index")
+			{
+				CHECK(batch.hand_size(1) == 2);
+				CHECK(batch.hand_size(0) == 0);
+				CHECK(batch.max_hand_size() == 2);
+				CHECK(batch.slot(0)[1] == static_cast<std::uint8_t>(Rank::King));
+				CHECK(batch.slot(1)[1] == static_cast<std::uint8_t>(Rank::Ace));
+				CHECK(batch.slot(0)[0] == 0);
+			}
+
+			AND_WHEN("Assigning it fewer cards")
+			{
+				const auto cards = std::vector<Card>{{Rank::Five, Suit::Spades}};
+				batch.assign(1, cards);
+
+				THEN("The slots it no longer uses are emptied")
+				{
+					CHECK(batch.hand_size(1) == 1);
+					CHECK(batch.slot(0)[1] == 5);
+					CHECK(batch.slot(1)[1] == 0);
+					CHECK(evaluate(batch)[1] == HandValue{5, false, 0});
+				}
+			}
+
+			AND_WHEN("Clearing the batch")
+			{
+				batch.clear();
+
+				THEN("Every hand is empty and worth nothing")
+				{
+					CHECK(batch.hand_size(1) == 0);
+					CHECK(evaluate(batch)[1] == HandValue{0, false, 0});
+				}
+			}
+		}
+	}
+}
+
+// ============================================================================
+// Batch values match calculate_hand_value
+// ============================================================================
+
+SCENARIO("Batch evaluation matches calculate_hand_value")
+{
+	GIVEN("Thousands of dealt hands of up to the maximum size")
+	{
+		const auto hands = dealt_hands(5000, HandBatch::max_cards);
+		const auto batch = make_batch(hands);
+
+		THEN("The vector evaluator gives every hand its calculated value")
+		{
+			CHECK(mismatches(hands, evaluate(batch)) == 0);
+		}
+
+		THEN("So does the scalar evaluator")
+		{
+			auto values = HandBatchValues{};
+			evaluate_scalar(batch, values);
+			CHECK(mismatches(hands, values) == 0);
+		}
+
+		THEN("Both evaluators agree on the padding too")
+		{
+			auto scalar = HandBatchValues{};
+			evaluate_scalar(batch, scalar);
+			const auto vector = evaluate(batch);
+			CHECK(vector.totals == scalar.totals);
+			CHECK(vector.soft == scalar.soft);
+		}
+	}
+
+	GIVEN("The largest and softest hands a batch can hold")
+	{
+		const auto hands = std::vector<std::vector<Card>>{
+			std::vector<Card>(HandBatch::max_cards, Card{Card::Rank::King, Card::Suit::Clubs}),
+			std::vector<Card>(HandBatch::max_cards, Card{Card::Rank::Ace, Card::Suit::Clubs}),
+			std::vector<Card>(11, Card{Card::Rank::Ace, Card::Suit::Clubs}),
+			std::vector<Card>{{Card::Rank::Ace, Card::Suit::Clubs}, {Card::Rank::Ten, Card::Suit::Clubs}},
+		};
+
+		THEN("Their values still match")
+		{
+			CHECK(mismatches(hands, evaluate(make_batch(hands))) == 0);
+		}
+	}
+}
+
+// ============================================================================
+// Dealer turns played in lockstep
+// ============================================================================
+
+SCENARIO("DealerBatch layout")
+{
+	using Rank = Card::Rank;
+	using Suit = Card::Suit;
+
+	GIVEN("A batch of three rounds")
+	{
+		auto batch = DealerBatch{3};
+
+		THEN("It is padded like a HandBatch and no dealer plays")
+		{
+			CHECK(batch.size() == 3);
+			CHECK(batch.stride() == DealerBatch::lanes);
+			CHECK(batch.plays()[0] == 0);
+		}
+
+		WHEN("The second dealer plays a soft 16 with a Five to draw")
+		{
+			const auto cards = std::vector<Card>{{Rank::Five, Suit::Clubs}};
+			batch.assign(1, {16, true, 1}, cards);
+
+			THEN("Its hard total, soft flag and draws land at its index")
+			{
+				CHECK(batch.hard_totals()[1] == 6);
+				CHECK(batch.soft()[1] == 1);
+				CHECK(batch.plays()[1] == 1);
+				CHECK(batch.draw(0)[1] == 5);
+				CHECK(batch.draw(1)[1] == 0);
+			}
+
+			THEN("It draws the Five to a soft 21")
+			{
+				auto turns = DealerTurns{};
+				play_dealer_turns(batch, true, turns);
+				CHECK(turns[1] == HandValue{21, true, 1});
+				CHECK(turns.draws[1] == 1);
+				CHECK(turns.draws[0] == 0);
+			}
+
+			AND_WHEN("Skipping it")
+			{
+				batch.skip(1);
+
+				THEN("It keeps its soft 16")
+				{
+					auto turns = DealerTurns{};
+					play_dealer_turns(batch, true, turns);
+					CHECK(turns[1] == HandValue{16, true, 1});
+					CHECK(turns.draws[1] == 0);
+				}
+			}
+
+			AND_WHEN("Resetting it to more rounds")
+			{
+				batch.reset(40);
+
+				THEN("It is padded to the new size and no dealer plays")
+				{
+					CHECK(batch.size() == 40);
+					CHECK(batch.stride() == 2 * DealerBatch::lanes);
+					CHECK(batch.plays()[1] == 0);
+				}
+			}
+		}
+	}
+}
+
+SCENARIO("Dealer turns played in lockstep match the dealer's turn in the game")
+{
+	GIVEN("Thousands of dealers' hands, each with the cards it would draw")
+	{
+		const auto deals = dealer_deals(5000);
+		const auto batch = make_dealer_batch(deals);
+		auto turns = DealerTurns{};
+
+		THEN("The vector turns end every dealer as the game does under both soft 17 rules")
+		{
+			play_dealer_turns(batch, true, turns);
+			CHECK(mismatches(deals, true, turns) == 0);
+			play_dealer_turns(batch, false, turns);
+			CHECK(mismatches(deals, false, turns) == 0);
+		}
+
+		THEN("So do the scalar turns")
+		{
+			play_dealer_turns_scalar(batch, true, turns);
+			CHECK(mismatches(deals, true, turns) == 0);
+			play_dealer_turns_scalar(batch, false, turns);
+			CHECK(mismatches(deals, false, turns) == 0);
+		}
+
+		THEN("Both agree on the padding too")
+		{
+			auto scalar = DealerTurns{};
+			play_dealer_turns_scalar(batch, true, scalar);
+			play_dealer_turns(batch, true, turns);
+			CHECK(turns.totals == scalar.totals);
+			CHECK(turns.soft == scalar.soft);
+			CHECK(turns.draws == scalar.draws);
+		}
+	}
+
+	GIVEN("Dealers drawing long runs of aces and twos")
+	{
+		const auto ace = Card{Card::Rank::Ace, Card::Suit::Clubs};
+		const auto two = Card{Card::Rank::Two, Card::Suit::Clubs};
+		const auto aces = std::vector<Card>(2 + DealerBatch::max_draws, ace);
+		const auto twos = std::vector<Card>(2 + DealerBatch::max_draws, two);
+		auto twos_then_aces = twos;
+		std::fill(twos_then_aces.begin() + 2, twos_then_aces.end(), ace);
+		const auto deals = std::vector<std::vector<Card>>{aces, twos, twos_then_aces};
+
+		THEN("Their turns still match, soft 17 hit or not")
+		{
+			auto turns = DealerTurns{};
+			play_dealer_turns(make_dealer_batch(deals), true, turns);
+			CHECK(mismatches(deals, true, turns) == 0);
+			play_dealer_turns(make_dealer_batch(deals), false, turns);
+			CHECK(mismatches(deals, false, turns) == 0);
+		}
+	}
+}
+
+// ============================================================================
+// Benchmarks (hidden; run with the [benchmark] tag)
+// ============================================================================
+
+SCENARIO("Batch hand evaluation throughput", "[.benchmark]")
+{
+	const auto hands = dealt_hands(1 << 16, 6);
+	const auto batch = make_batch(hands);
+	auto values = HandBatchValues{};
+
+	BENCHMARK("calculate_hand_value, one hand at a time")
+	{
+		auto sum = 0;
+		for (const auto& hand : hands)
+			sum += calculate_hand_value(hand).total;
+		return sum;
+	};
+
+	BENCHMARK("evaluate_scalar")
+	{
+		evaluate_scalar(batch, values);
+		return values.totals[0];
+	};
+
+	BENCHMARK("evaluate")
+	{
+		evaluate(batch, values);
+		return values.totals[0];
+	};
+}
+
+SCENARIO("Lockstep dealer turn throughput", "[.benchmark]")
+{
+	const auto deals = dealer_deals(1 << 14);
+	const auto batch = make_dealer_batch(deals);
+	auto turns = DealerTurns{};
+
+	BENCHMARK("DealersHand, one turn at a time")
+	{
+		auto sum = std::size_t{0};
+		for (const auto& deal : deals)
+			sum += dealer_turn(deal, true).second;
+		return sum;
+	};
+
+	BENCHMARK("play_dealer_turns_scalar")
+	{
+		play_dealer_turns_scalar(batch, true, turns);
+		return turns.totals[0];
+	};
+
+	BENCHMARK("play_dealer_turns")
+	{
+		play_dealer_turns(batch, true, turns);
+		return turns.totals[0];
+	};
+}
@@ -0,0 +1,158 @@
+#include <blackjack-game.h>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <vector>
+
+using namespace CardGames::BlackJack;
+
+namespace
+{
+	/// The per-card switch and ace reduction loop the lookup tables replaced, kept as the
+	/// reference they are checked and benchmarked against
+	HandValue reference_hand_value(std::span<const Card> hand)
+	{
+		int total = 0;
+		int ace_count = 0;
+
+		for (const auto& card : hand) {
+			switch (card.rank()) {
+				case Card::Rank::Ace:
+					total += 11;
+					++ace_count;
+					break;
+				case Card::Rank::King:
+				case Card::Rank::Queen:
+				case Card::Rank::Jack: total += 10; break;
+				default: total += static_cast<int>(card.rank()); break;
+			}
+		}
+
+		int soft_ace_count = ace_count;
+		while (total > 21 && soft_ace_count > 0) {
+			total -= 10;
+			--soft_ace_count;
+		}
+
+		return {total, soft_ace_count > 0, soft_ace_count};
+	}
+
+	/// Points of a rank with aces counted as 1
+	int hard_points(Card::Rank rank)
+	{
+		return rank == Card::Rank::Ace ? 1 : std::min(static_cast<int>(rank), 10);
+	}
+
+	/// Calls visit with every multiset of ranks whose hard total is at most max_hard_total,
+	/// ranks in the order of Card::ranks()
+	template <typename Visit>
+	void for_each_composition(int max_hard_total, Visit visit)
+	{
+		const auto& ranks = Card::ranks();
+		auto hand = std::vector<Card>{};
+		const auto extend = [&](const auto& self, std::size_t first_rank, int hard_total) -> void {
+			visit(hand);
+			for (auto r = first_rank; r < ranks.size(); ++r) {
+				const auto points = hard_points(ranks[r]);
+				if (hard_total + points > max_hard_total)
+					continue;
+				hand.push_back({ranks[r], Card::Suit::Clubs});
+				self(self, r, hard_total + points);
+				hand.pop_back();
+			}
+		};
+		extend(extend, 0, 0);
+	}
+
+	/// Hands of two to six cards dealt from a shuffled eight-deck shoe
+	std::vector<std::vector<Card>> sample_hands()
+	{
+		auto rng = Rng{2025};
+		auto hands = std::vector<std::vector<Card>>{};
+		for (int shoe = 0; shoe < 16; ++shoe) {
+			auto deck = shuffle(Shoe{{.decks = 8}}.deck(), rng);
+			for (std::size_t size = 2; deck.cards().size() >= size; size = size % 6 + 2) {
+				const auto cards = deck.deal(size);
+				hands.emplace_back(cards.begin(), cards.end());
+			}
+		}
+		return hands;
+	}
+} // namespace
+
+// ============================================================================
+// Lookup tables match the reference evaluator
+// ============================================================================
+
+SCENARIO("Table-driven hand values match the reference evaluator")
+{
+	GIVEN("Every composition of ranks a player or dealer can hold")
+	{
+		// A hand stops drawing at 21 at most, so no reachable hand's hard total exceeds 21 + 10
+		constexpr auto max_hard_total = 31;
+
+		THEN("calculate_hand_value agrees with the reference for each of them")
+		{
+			auto compositions = 0;
+			auto mismatches = 0;
+			for_each_composition(max_hard_total, [&](const std::vector<Card>& hand) {
+				++compositions;
+				if (calculate_hand_value(hand) != reference_hand_value(hand))
+					++mismatches;
+			});
+			CHECK(compositions > 10'000);
+			CHECK(mismatches == 0);
+		}
+
+		THEN("Building each of them a card at a time with add_card agrees too")
+		{
+			auto mismatches = 0;
+			for_each_composition(max_hard_total, [&](const std::vector<Card>& hand) {
+				auto value = HandValue{};
+				for (const auto& card : hand)
+					value = add_card(value, card);
+				if (value != reference_hand_value(hand))
+					++mismatches;
+			});
+			CHECK(mismatches == 0);
+		}
+	}
+
+	GIVEN("Hands far past a bust")
+	{
+		const auto aces = std::vector<Card>(40, Card{Card::Rank::Ace, Card::Suit::Spades});
+		const auto kings = std::vector<Card>(10, Card{Card::Rank::King, Card::Suit::Hearts});
+
+		THEN("They still agree with the reference")
+		{
+			CHECK(calculate_hand_value(aces) == reference_hand_value(aces));
+			CHECK(calculate_hand_value(kings) == reference_hand_value(kings));
+		}
+	}
+}
+
+// ============================================================================
+// Benchmarks (hidden; run with the [benchmark] tag)
+// ============================================================================
+
+SCENARIO("Hand evaluation throughput", "[.benchmark]")
+{
+	const auto hands = sample_hands();
+
+	BENCHMARK("Reference switch evaluator")
+	{
+		auto sum = 0;
+		for (const auto& hand : hands)
+			sum += reference_hand_value(hand).total;
+		return sum;
+	};
+
+	BENCHMARK("Lookup table evaluator")
+	{
+		auto sum = 0;
+		for (const auto& hand : hands)
+			sum += calculate_hand_value(hand).total;
+		return sum;
+	};
+}
@@ -0,0 +1,324 @@
+#include <blackjack-game.h>
+#include <catch2/catch_test_macros.hpp>
+#include <history.h>
+
+using namespace CardGames::BlackJack;
+
+// ============================================================================
+// Retention limits
+// ============================================================================
+
+SCENARIO("History retention limits")
+{
+	GIVEN("A full history")
+	{
+		auto history = History<int>{};
+
+		WHEN("Appending many states")
+		{
+			for (int i = 0; i < 1000; ++i)
+				history.push_back(i);
+
+			THEN("It keeps all of them, oldest first")
+			{
+				REQUIRE(history.size() == 1000);
+				CHECK(history.front() == 0);
+				CHECK(history[500] == 500);
+				CHECK(history.back() == 999);
+				CHECK_FALSE(history.replaces_back());
+			}
+		}
+	}
+
+	GIVEN("A history keeping the last three states")
+	{
+		auto history = History<int>{{.retention = HistoryRetention::LastN, .depth = 3}};
+
+		WHEN("Appending fewer states than its depth")
+		{
+			history.push_back(1);
+			history.push_back(2);
+
+			THEN("It keeps all of them")
+			{
+				REQUIRE(history.size() == 2);
+				CHECK(history.front() == 1);
+				CHECK(history.back() == 2);
+			}
+		}
+
+		WHEN("Appending more states than its depth")
+		{
+			for (int i = 1; i <= 7; ++i)
+				history.push_back(i);
+
+			THEN("It keeps only the last three, oldest first")
+			{
+				REQUIRE(history.size() == 3);
+				CHECK(history[0] == 5);
+				CHECK(history[1] == 6);
+				CHECK(history[2] == 7);
+			}
+
+			AND_WHEN("Clearing it")
+			{
+				history.clear();
+				history.push_back(42);
+
+				THEN("It starts again from the new state")
+				{
+					REQUIRE(history.size() == 1);
+					CHECK(history.front() == 42);
+					CHECK(history.back() == 42);
+				}
+			}
+		}
+	}
+
+	GIVEN("A history keeping the last zero states")
+	{
+		const auto history = History<int>{{.retention = HistoryRetention::LastN, .depth = 0}};
+
+		THEN("It still keeps the current state")
+		{
+			CHECK(history.capacity_limit() == 1);
+		}
+	}
+
+	GIVEN("A history keeping only the current state")
+	{
+		auto history = History<std::vector<int>>{{.retention = HistoryRetention::CurrentOnly}};
+		history.push_back({1, 2, 3});
+
+		WHEN("Appending a state built from the current one")
+		{
+			history.emplace_back(history.back().begin() + 1, history.back().end());
+
+			THEN("The new state is built before the current one is replaced")
+			{
+				REQUIRE(history.size() == 1);
+				CHECK(history.back() == std::vector<int>{2, 3});
+			}
+		}
+
+		THEN("The next state replaces the current one, which may be moved from")
+		{
+			CHECK(history.replaces_back());
+		}
+
+		WHEN("Moving the current state into the one that replaces it")
+		{
+			history.emplace_back(std::move(history.back()));
+
+			THEN("Nothing is copied or lost")
+			{
+				REQUIRE(history.size() == 1);
+				CHECK(history.back() == std::vector<int>{1, 2, 3});
+			}
+		}
+	}
+}
+
+// ============================================================================
+// Stable storage
+// ============================================================================
+
+SCENARIO("History never moves a retained state")
+{
+	GIVEN("A full history of vectors")
+	{
+		auto history = History<std::vector<int>, 4>{};
+		const auto& first = history.push_back({1, 2, 3});
+		const auto* first_data = first.data();
+
+		WHEN("Appending enough states to fill many segments")
+		{
+			for (int i = 0; i < 100; ++i)
+				history.push_back(std::vector<int>(3, i));
+
+			THEN("References to earlier states still refer to them")
+			{
+				CHECK(&history.front() == &first);
+				CHECK(first.data() == first_data);
+				CHECK(first == std::vector<int>{1, 2, 3});
+				CHECK(history[50] == std::vector<int>(3, 49));
+			}
+		}
+
+		WHEN("Copying it and appending many states to the copy")
+		{
+			for (int i = 0; i < 5; ++i)
+				history.push_back(std::vector<int>(3, i));
+			auto copy = history;
+			const auto& copied_first = copy.front();
+			const auto& copied_last = copy.back();
+			const auto* copied_first_data = copied_first.data();
+			for (int i = 0; i < 100; ++i)
+				copy.push_back({i});
+
+			THEN("References to the copy's earlier states still refer to them")
+			{
+				CHECK(&copy.front() == &copied_first);
+				CHECK(&copy[5] == &copied_last);
+				CHECK(copied_first.data() == copied_first_data);
+				CHECK(copied_first == std::vector<int>{1, 2, 3});
+				CHECK(copied_last == std::vector<int>(3, 4));
+			}
+
+			THEN("The original is unchanged")
+			{
+				CHECK(history.size() == 6);
+				CHECK(&history.front() == &first);
+				CHECK(&history.front() != &copied_first);
+			}
+		}
+
+		WHEN("Assigning it over a history and appending to that")
+		{
+			auto other = History<std::vector<int>, 4>{};
+			for (int i = 0; i < 9; ++i)
+				other.push_back({i});
+			other = history;
+			const auto& assigned_first = other.front();
+			for (int i = 0; i < 100; ++i)
+				other.push_back({i});
+
+			THEN("References to its earlier states still refer to them")
+			{
+				CHECK(other.size() == 101);
+				CHECK(&other.front() == &assigned_first);
+				CHECK(assigned_first == std::vector<int>{1, 2, 3});
+			}
+		}
+
+		WHEN("Clearing it and appending again")
+		{
+			for (int i = 0; i < 10; ++i)
+				history.push_back({i});
+			const auto* tenth = &history[9];
+			history.clear();
+			for (int i = 0; i < 10; ++i)
+				history.push_back({-i});
+
+			THEN("The same slots are reused")
+			{
+				CHECK(&history[9] == tenth);
+				CHECK(history[9] == std::vector<int>{-9});
+			}
+		}
+	}
+
+	GIVEN("A game with full history")
+	{
+		auto game = Game{{.seed = 30}};
+		const auto& ready = game.state();
+
+		WHEN("Playing a round")
+		{
+			game.next(Game::Play::Deal);
+			while (game.state().node() == GameNode::PlayersRound)
+				game.next(Game::Play::Stay);
+
+			THEN("The state returned before the round is still the first in the history")
+			{
+				CHECK(&game.history().front() == &ready);
+				CHECK(ready.node() == GameNode::Ready);
+			}
+		}
+	}
+}
+
+// ============================================================================
+// Games under each retention mode
+// ============================================================================
+
+SCENARIO("Game history retention")
+{
+	const auto play_round = [](Game& game) {
+		game.next(Game::Play::Deal);
+		while (game.state().node() == GameNode::PlayersRound)
+			game.next(Game::Play::Hit);
+	};
+
+	GIVEN("Games with the same seed under each retention mode")
+	{
+		auto full = Game{{.seed = 12}};
+		auto last_two =
+			Game{{.seed = 12, .history = {.retention = HistoryRetention::LastN, .depth = 2}}};
+		auto current = Game{{.seed = 12, .history = {.retention = HistoryRetention::CurrentOnly}}};
+
+		WHEN("Playing a round in each")
+		{
+			play_round(full);
+			play_round(last_two);
+			play_round(current);
+
+			THEN("They reach the same state")
+			{
+				CHECK(last_two.state() == full.state());
+				CHECK(current.state() == full.state());
+			}
+
+			THEN("A full history holds every state from Ready on")
+			{
+				CHECK(full.history().size() >= 2);
+				CHECK(full.history().front().node() == GameNode::Ready);
+				CHECK(full.history().back() == full.state());
+			}
+
+			THEN("The others hold only the most recent states")
+			{
+				REQUIRE(last_two.history().size() == 2);
+				CHECK(last_two.history()[0] == full.history()[full.history().size() - 2]);
+				CHECK(last_two.history()[1] == full.state());
+				CHECK(current.history().size() == 1);
+			}
+		}
+
+		WHEN("Playing a session that splits every pair, keeping only the current state")
+		{
+			auto splits = 0;
+			auto mismatches = 0;
+			for (int round = 0; round < 300; ++round) {
+				full.next(Game::Play::Deal);
+				current.next(Game::Play::Deal);
+				while (full.state().node() == GameNode::PlayersRound ||
+							 full.state().node() == GameNode::PlayersSplitRound) {
+					auto play = Game::Play::Stay;
+					if (full.state().can_split())
+						play = Game::Play::Split;
+					else if (full.state().players_hand().active_total() < 17)
+						play = Game::Play::Hit;
+					splits += play == Game::Play::Split;
+					full.next(play);
+					current.next(play);
+					if (current.state() != full.state())
+						++mismatches;
+				}
+				full.new_round();
+				current.new_round();
+			}
+
+			THEN("Every state matches the game that keeps its whole history")
+			{
+				CHECK(splits > 0);
+				CHECK(mismatches == 0);
+				CHECK(current.state() == full.state());
+			}
+		}
+
+		WHEN("Playing many rounds keeping only the current state")
+		{
+			for (int round = 0; round < 1000; ++round) {
+				play_round(current);
+				current.new_round();
+			}
+
+			THEN("The history never grows")
+			{
+				CHECK(current.history().size() == 1);
+				CHECK(current.state().node() == GameNode::Ready);
+			}
+		}
+	}
+}
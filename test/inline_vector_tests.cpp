@@ -0,0 +1,161 @@
+#include <card.h>
+#include <catch2/catch_test_macros.hpp>
+#include <inline-vector.h>
+
+#include <span>
+#include <type_traits>
+#include <vector>
+
+using Rank = Card::Rank;
+using Suit = Card::Suit;
+
+// ============================================================================
+// Construction and element access
+// ============================================================================
+
+SCENARIO("InlineVector construction and access")
+{
+	GIVEN("An empty InlineVector")
+	{
+		auto cards = InlineVector<Card, 4>{};
+
+		THEN("It has no elements and a fixed capacity")
+		{
+			CHECK(cards.empty());
+			CHECK(cards.size() == 0);
+			CHECK(cards.capacity() == 4);
+			CHECK(cards.begin() == cards.end());
+		}
+
+		WHEN("Pushing back cards up to its capacity")
+		{
+			cards.push_back({Rank::Two, Suit::Clubs});
+			cards.push_back({Rank::Three, Suit::Hearts});
+			cards.push_back({Rank::Four, Suit::Spades});
+			cards.push_back({Rank::Five, Suit::Diamonds});
+
+			THEN("They are held in order")
+			{
+				REQUIRE(cards.size() == 4);
+				CHECK(cards.front() == Card{Rank::Two, Suit::Clubs});
+				CHECK(cards[1] == Card{Rank::Three, Suit::Hearts});
+				CHECK(cards.back() == Card{Rank::Five, Suit::Diamonds});
+			}
+
+			AND_WHEN("Popping the last one")
+			{
+				cards.pop_back();
+
+				THEN("It is gone")
+				{
+					CHECK(cards.size() == 3);
+					CHECK(cards.back() == Card{Rank::Four, Suit::Spades});
+				}
+			}
+
+			AND_WHEN("Clearing it")
+			{
+				cards.clear();
+
+				THEN("It is empty and equal to a new one")
+				{
+					CHECK(cards.empty());
+					CHECK(cards == InlineVector<Card, 4>{});
+				}
+			}
+		}
+	}
+
+	GIVEN("InlineVectors built from a list and from a span")
+	{
+		const auto list = InlineVector<Card, 4>{{Rank::Ace, Suit::Spades}, {Rank::Ten, Suit::Hearts}};
+		const auto source = std::vector<Card>{{Rank::Ace, Suit::Spades}, {Rank::Ten, Suit::Hearts}};
+		const auto copied = InlineVector<Card, 4>{std::span{source}};
+
+		THEN("They hold the same cards")
+		{
+			CHECK(list.size() == 2);
+			CHECK(list == copied);
+		}
+
+		THEN("They view as a span without copying")
+		{
+			const auto view = std::span<const Card>{list};
+			CHECK(view.data() == list.data());
+			CHECK(view.size() == 2);
+		}
+	}
+
+	GIVEN("An InlineVector with room for one more")
+	{
+		auto ranks = InlineVector<Rank, 4>{Rank::Two, Rank::Four, Rank::Five};
+
+		WHEN("Inserting in the middle")
+		{
+			const auto it = ranks.insert(ranks.begin() + 1, Rank::Three);
+
+			THEN("The later elements shift along in place")
+			{
+				CHECK(it == ranks.begin() + 1);
+				CHECK(ranks == InlineVector<Rank, 4>{Rank::Two, Rank::Three, Rank::Four, Rank::Five});
+			}
+		}
+
+		WHEN("Inserting at the end")
+		{
+			ranks.insert(ranks.end(), Rank::Six);
+
+			THEN("It is appended")
+			{
+				CHECK(ranks.size() == 4);
+				CHECK(ranks.back() == Rank::Six);
+			}
+		}
+	}
+}
+
+// ============================================================================
+// Value semantics
+// ============================================================================
+
+SCENARIO("InlineVector value semantics")
+{
+	THEN("An InlineVector of cards is trivially copyable and never allocates")
+	{
+		STATIC_REQUIRE(std::is_trivially_copyable_v<InlineVector<Card, 22>>);
+	}
+
+	GIVEN("Two InlineVectors with different cards")
+	{
+		auto a = InlineVector<Card, 4>{{Rank::King, Suit::Clubs}};
+		const auto b = InlineVector<Card, 4>{{Rank::King, Suit::Hearts}};
+
+		THEN("They are not equal")
+		{
+			CHECK(a != b);
+		}
+
+		WHEN("Copying one over the other")
+		{
+			a = b;
+
+			THEN("They are equal and independent")
+			{
+				CHECK(a == b);
+				a.push_back({Rank::Two, Suit::Clubs});
+				CHECK(b.size() == 1);
+			}
+		}
+
+		WHEN("One loses a card it had and the other never had")
+		{
+			a.pop_back();
+			const auto c = InlineVector<Card, 4>{};
+
+			THEN("Only the live elements decide equality")
+			{
+				CHECK(a == c);
+			}
+		}
+	}
+}
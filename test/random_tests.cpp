@@ -0,0 +1,155 @@
+#include <array>
+#include <card-set.h>
+#include <catch2/catch_test_macros.hpp>
+#include <deck.h>
+#include <random.h>
+
+// ============================================================================
+// Seeding
+// ============================================================================
+
+SCENARIO("Rng seeding")
+{
+	GIVEN("Two engines with the same seed")
+	{
+		auto a = Rng{42};
+		auto b = Rng{42};
+
+		THEN("They produce the same sequence")
+		{
+			for (int i = 0; i < 100; ++i) {
+				CHECK(a() == b());
+			}
+		}
+	}
+
+	GIVEN("Two engines with different seeds")
+	{
+		auto a = Rng{42};
+		auto b = Rng{43};
+
+		THEN("They produce different sequences")
+		{
+			CHECK(a() != b());
+		}
+	}
+
+	GIVEN("Two streams of the same seed")
+	{
+		auto a = Rng{42, 0};
+		auto b = Rng{42, 1};
+
+		THEN("They produce different sequences")
+		{
+			CHECK(a != b);
+			CHECK(a() != b());
+		}
+	}
+
+	GIVEN("A copy of an engine")
+	{
+		auto a = Rng{7};
+		a();
+		auto b = a;
+
+		THEN("The copy continues the same sequence")
+		{
+			CHECK(a() == b());
+		}
+	}
+}
+
+// ============================================================================
+// Bounded integers
+// ============================================================================
+
+SCENARIO("Rng bounded integers")
+{
+	GIVEN("A seeded engine")
+	{
+		auto rng = Rng{1234};
+
+		THEN("A bound of 1 always yields 0")
+		{
+			for (int i = 0; i < 100; ++i) {
+				CHECK(rng.bounded(1) == 0);
+			}
+		}
+
+		THEN("Values stay below the bound and every value occurs about equally often")
+		{
+			constexpr auto bound = 13u;
+			constexpr auto draws = 130'000;
+			auto counts = std::array<int, bound>{};
+			auto out_of_range = 0;
+			for (int i = 0; i < draws; ++i) {
+				const auto value = rng.bounded(bound);
+				if (value < bound)
+					++counts[value];
+				else
+					++out_of_range;
+			}
+			CHECK(out_of_range == 0);
+			for (const auto count : counts) {
+				CHECK(count > 9'000);
+				CHECK(count < 11'000);
+			}
+		}
+	}
+}
+
+// ============================================================================
+// Seeded shuffling
+// ============================================================================
+
+SCENARIO("Shuffling with a seeded engine")
+{
+	GIVEN("Two engines with the same seed")
+	{
+		auto a = Rng{99};
+		auto b = Rng{99};
+
+		WHEN("Shuffling a default deck with each")
+		{
+			const auto da = shuffle(Deck{}, a);
+			const auto db = shuffle(Deck{}, b);
+
+			THEN("The decks are in the same order")
+			{
+				CHECK(da == db);
+			}
+
+			THEN("The deck is no longer in its default order")
+			{
+				CHECK(da != Deck{});
+			}
+
+			THEN("The deck still holds every card exactly once")
+			{
+				REQUIRE(da.cards().size() == 52);
+				CHECK(CardSet{da.cards()} == CardSet::full_deck());
+			}
+		}
+
+		WHEN("Shuffling twice with the same engine")
+		{
+			const auto first = shuffle(Deck{}, a);
+			const auto second = shuffle(Deck{}, a);
+
+			THEN("The engine advances and the orders differ")
+			{
+				CHECK(first != second);
+			}
+		}
+	}
+
+	GIVEN("An empty deck")
+	{
+		auto rng = Rng{1};
+
+		THEN("Shuffling it yields an empty deck")
+		{
+			CHECK(shuffle(Deck{std::vector<Card>{}}, rng).cards().empty());
+		}
+	}
+}
@@ -0,0 +1,265 @@
+#include <blackjack-game.h>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <round-engine.h>
+#include <simulation.h>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+using namespace CardGames::BlackJack;
+
+namespace
+{
+	using Rank = Card::Rank;
+	using Suit = Card::Suit;
+
+	/// Splits whatever it may, so rounds reach four hands, and otherwise hits below 17. Works on
+	/// a GameState and a RoundRecord alike.
+	Play split_then_hit_below_17(const auto& state)
+	{
+		if (state.legal_moves().contains(Play::Split))
+			return Play::Split;
+		return state.players_hand().active_total() < 17 ? Play::Hit : Play::Stay;
+	}
+
+	/// Splits aces and eights, hits soft hands below 18 and hard hands by the dealer's upcard
+	Play split_some_and_stand_by_upcard(const auto& state)
+	{
+		const auto cards = state.players_hand().active_cards();
+		if (state.legal_moves().contains(Play::Split) &&
+				(cards[0].rank() == Rank::Ace || cards[0].rank() == Rank::Eight))
+			return Play::Split;
+		const auto& value = state.players_hand().active_value();
+		if (value.is_soft)
+			return value.total < 18 ? Play::Hit : Play::Stay;
+		const auto upcard = add_em_up(state.dealer_hand().cards().subspan(1, 1));
+		if (value.total <= 11)
+			return Play::Hit;
+		return value.total < 17 && upcard >= 7 ? Play::Hit : Play::Stay;
+	}
+
+	/// Asks for a play no state accepts, which is played as Stay
+	Play always_deal(const auto&)
+	{
+		return Play::Deal;
+	}
+
+	/// The shuffled cards of a six-deck shoe for deal number i of seed
+	std::vector<Card> shuffled_shoe(std::uint64_t seed, std::uint64_t i)
+	{
+		auto rng = Rng{seed, i};
+		const auto deck = shuffle(Shoe{{.decks = 6}}.deck(), rng);
+		return {deck.begin(), deck.end()};
+	}
+
+	/// Plays rounds seeded deals through Game and RoundEngine under the same rules and decisions
+	/// and counts the rounds where they differ in outcome, hands or cards dealt
+	template <typename Rules>
+	std::uint64_t count_differences(std::uint64_t rounds, std::uint64_t seed, auto decide)
+	{
+		const auto engine = RoundEngine<Rules>{};
+		const auto strategy = Strategy{decide};
+		auto record = RoundRecord{};
+		auto differences = std::uint64_t{0};
+		for (std::uint64_t i = 0; i < rounds; ++i) {
+			const auto cards = shuffled_shoe(seed, i);
+			auto game = BasicGame<Rules>{Rules::apply(
+				{.initial_deck = Deck{cards}, .history = {.retention = HistoryRetention::CurrentOnly}})};
+			const auto* state = &game.next(Play::Deal);
+			while (state->node() == GameNode::PlayersRound ||
+						 state->node() == GameNode::PlayersSplitRound) {
+				auto play = strategy(*state);
+				if (!state->legal_moves().contains(play))
+					play = Play::Stay;
+				state = &game.next(play);
+			}
+
+			engine.play(cards, decide, record);
+			const auto same = record.node() == state->node() &&
+												record.players_hand() == state->players_hand() &&
+												record.dealer_hand() == state->dealer_hand() &&
+												record.cards_dealt() == cards.size() - state->deck().cards().size();
+			differences += same ? 0 : 1;
+		}
+		return differences;
+	}
+
+	template <typename Rules>
+	std::uint64_t count_differences(std::uint64_t rounds, std::uint64_t seed)
+	{
+		return count_differences<Rules>(rounds, seed, [](const auto& s) {
+						 return split_then_hit_below_17(s);
+					 }) +
+					 count_differences<Rules>(rounds, seed + 1, [](const auto& s) {
+						 return split_some_and_stand_by_upcard(s);
+					 }) +
+					 count_differences<Rules>(rounds / 16, seed + 2, [](const auto& s) {
+						 return always_deal(s);
+					 });
+	}
+} // namespace
+
+// ============================================================================
+// Single rounds
+// ============================================================================
+
+SCENARIO("RoundEngine plays a round from a span of cards")
+{
+	const auto engine = RoundEngine<FixedRules<true, false>>{};
+	auto record = RoundRecord{};
+
+	GIVEN("Cards dealing the player a blackjack")
+	{
+		const auto cards = std::vector<Card>{{Rank::Ace, Suit::Spades},
+																				 {Rank::Nine, Suit::Clubs},
+																				 {Rank::King, Suit::Hearts},
+																				 {Rank::Seven, Suit::Clubs}};
+
+		WHEN("Playing the round")
+		{
+			engine.play(cards, split_then_hit_below_17<RoundRecord>, record);
+
+			THEN("The player wins on the deal with no decision to make")
+			{
+				CHECK(record.node() == GameNode::GameOverPlayerWins);
+				CHECK(record.legal_moves().empty());
+				CHECK(record.cards_dealt() == 4);
+			}
+		}
+	}
+
+	GIVEN("Cards giving the player 18 and the dealer a soft 17, then a Two")
+	{
+		const auto cards = std::vector<Card>{{Rank::Ten, Suit::Clubs},
+																				 {Rank::Ace, Suit::Hearts},
+																				 {Rank::Eight, Suit::Clubs},
+																				 {Rank::Six, Suit::Hearts},
+																				 {Rank::Two, Suit::Spades}};
+
+		WHEN("The dealer hits soft 17")
+		{
+			engine.play(cards, split_then_hit_below_17<RoundRecord>, record);
+
+			THEN("The dealer draws to 19 and wins")
+			{
+				CHECK(record.node() == GameNode::GameOverDealerWins);
+				CHECK(record.dealer_hand().total() == 19);
+				CHECK(record.cards_dealt() == 5);
+			}
+		}
+
+		WHEN("The dealer stands on soft 17")
+		{
+			RoundEngine<FixedRules<false, false>>{}.play(cards, split_then_hit_below_17<RoundRecord>,
+																									 record);
+
+			THEN("The player wins without the Two being dealt")
+			{
+				CHECK(record.node() == GameNode::GameOverPlayerWins);
+				CHECK(record.cards_dealt() == 4);
+			}
+		}
+	}
+
+	GIVEN("Cards dealing a pair of eights against 17, each split hand then drawing to 18")
+	{
+		const auto cards = std::vector<Card>{{Rank::Eight, Suit::Clubs},
+																				 {Rank::Ten, Suit::Clubs},
+																				 {Rank::Eight, Suit::Hearts},
+																				 {Rank::Seven, Suit::Clubs},
+																				 {Rank::Ten, Suit::Hearts},
+																				 {Rank::Jack, Suit::Spades},
+																				 {Rank::Queen, Suit::Hearts}};
+
+		WHEN("Splitting and standing")
+		{
+			engine.play(cards, split_then_hit_below_17<RoundRecord>, record);
+
+			THEN("Both hands stand and the dealer's 17 loses to the last one")
+			{
+				REQUIRE(record.players_hand().hand_count() == 2);
+				CHECK(record.players_hand().all_hands()[0].value.total == 18);
+				CHECK(record.players_hand().all_hands()[1].value.total == 18);
+				CHECK(record.node() == GameNode::GameOverPlayerWins);
+				CHECK(record.cards_dealt() == 6);
+			}
+		}
+	}
+}
+
+// ============================================================================
+// Differential test against Game
+// ============================================================================
+
+SCENARIO("RoundEngine plays seeded deals exactly as Game does")
+{
+	GIVEN("Seeded six-deck deals played with strategies that split, hit, stand and misplay")
+	{
+		constexpr auto rounds = std::uint64_t{5'000};
+
+		THEN("Every round has the same outcome, hands and cards dealt under every rule set")
+		{
+			CHECK(count_differences<FixedRules<false, false>>(rounds, 11) == 0);
+			CHECK(count_differences<FixedRules<false, true>>(rounds, 21) == 0);
+			CHECK(count_differences<FixedRules<true, false>>(rounds, 31) == 0);
+			CHECK(count_differences<FixedRules<true, true>>(rounds, 41) == 0);
+		}
+	}
+}
+
+SCENARIO("RoundEngine matches Game over millions of seeded deals", "[.differential]")
+{
+	constexpr auto rounds = std::uint64_t{1'000'000};
+
+	CHECK(count_differences<FixedRules<false, false>>(rounds, 12) == 0);
+	CHECK(count_differences<FixedRules<false, true>>(rounds, 22) == 0);
+	CHECK(count_differences<FixedRules<true, false>>(rounds, 32) == 0);
+	CHECK(count_differences<FixedRules<true, true>>(rounds, 42) == 0);
+}
+
+// ============================================================================
+// Benchmarks (hidden; run with the [benchmark] tag)
+// ============================================================================
+
+SCENARIO("Round throughput of Game and RoundEngine", "[.benchmark]")
+{
+	constexpr auto rounds = 1'000;
+
+	BENCHMARK_ADVANCED("Game, a session dealt from a six-deck shoe")(auto meter)
+	{
+		auto game = Game{{.seed = 7,
+											.shoe = {.decks = 6, .reshuffle = ReshufflePolicy::CutCard},
+											.history = {.retention = HistoryRetention::CurrentOnly}}};
+		meter.measure([&] {
+			auto wins = 0;
+			for (int i = 0; i < rounds; ++i) {
+				game.new_round();
+				wins += play_round(game, split_some_and_stand_by_upcard<GameState>) ==
+								GameNode::GameOverPlayerWins;
+			}
+			return wins;
+		});
+	};
+
+	BENCHMARK_ADVANCED("RoundEngine, dealing through a six-deck shoe")(auto meter)
+	{
+		const auto engine = RoundEngine<ConfiguredRules>{};
+		const auto cards = shuffled_shoe(7, 0);
+		auto record = RoundRecord{};
+		meter.measure([&] {
+			auto wins = 0;
+			auto top = std::size_t{0};
+			for (int i = 0; i < rounds; ++i) {
+				if (cards.size() - top < max_round_cards(6))
+					top = 0;
+				engine.play(std::span{cards}.subspan(top), split_some_and_stand_by_upcard<RoundRecord>,
+										record);
+				top += record.cards_dealt();
+				wins += record.node() == GameNode::GameOverPlayerWins;
+			}
+			return wins;
+		});
+	};
+}
@@ -0,0 +1,443 @@
+#include <blackjack-game.h>
+#include <card-set.h>
+#include <catch2/catch_test_macros.hpp>
+#include <shoe.h>
+
+#include <algorithm>
+
+using namespace CardGames::BlackJack;
+
+namespace
+{
+	/// Deals num_cards from a copy of the shoe's deck and hands the rest back
+	void deal_from(Shoe& shoe, std::size_t num_cards)
+	{
+		auto deck = shoe.deck();
+		deck.deal(num_cards);
+		shoe.update(deck);
+	}
+} // namespace
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+SCENARIO("Shoe construction")
+{
+	GIVEN("A default shoe")
+	{
+		const auto shoe = Shoe{};
+
+		THEN("It holds a single deck")
+		{
+			CHECK(shoe.size() == 52);
+			CHECK(shoe.deck() == Deck{});
+			CHECK(shoe.dealt() == 0);
+		}
+
+		THEN("It must be shuffled before use")
+		{
+			CHECK(shoe.needs_reshuffle());
+		}
+	}
+
+	GIVEN("A six-deck shoe")
+	{
+		auto shoe = Shoe{{.decks = 6, .penetration = 0.75, .reshuffle = ReshufflePolicy::CutCard}};
+
+		THEN("It holds 312 cards, six of each")
+		{
+			REQUIRE(shoe.deck().cards().size() == 312);
+			CHECK(is_full_decks(shoe.deck().cards(), 6));
+		}
+
+		THEN("The cut card is three quarters of the way in")
+		{
+			CHECK(shoe.cut_card() == 234);
+		}
+
+		WHEN("Shuffling it")
+		{
+			auto rng = Rng{5};
+			shoe.shuffle(rng);
+
+			THEN("It still holds six of each card, in a new order")
+			{
+				REQUIRE(shoe.deck().cards().size() == 312);
+				CHECK(is_full_decks(shoe.deck().cards(), 6));
+				CHECK(shoe.deck() != Shoe{shoe.config()}.deck());
+			}
+
+			THEN("It no longer needs shuffling")
+			{
+				CHECK_FALSE(shoe.needs_reshuffle());
+			}
+		}
+	}
+}
+
+// ============================================================================
+// Cut card placement
+// ============================================================================
+
+SCENARIO("Shoe cut card placement")
+{
+	GIVEN("A single deck with full penetration")
+	{
+		const auto shoe = Shoe{{.decks = 1, .penetration = 1.0, .reshuffle = ReshufflePolicy::CutCard}};
+
+		THEN("The cut card leaves the reserve behind it")
+		{
+			CHECK(shoe.reserve_cards() == max_round_cards(1));
+			CHECK(shoe.cut_card() == 52 - shoe.reserve_cards());
+		}
+	}
+
+	GIVEN("A penetration outside [0, 1]")
+	{
+		const auto deep = Shoe{{.decks = 2, .penetration = 3.0}};
+		const auto shallow = Shoe{{.decks = 2, .penetration = -1.0}};
+
+		THEN("It is clamped")
+		{
+			CHECK(deep.cut_card() == 104 - deep.reserve_cards());
+			CHECK(shallow.cut_card() == 0);
+		}
+	}
+}
+
+// ============================================================================
+// Reshuffle policies
+// ============================================================================
+
+SCENARIO("Shoe reshuffle policies")
+{
+	auto rng = Rng{11};
+
+	GIVEN("A shuffled shoe reshuffled every round")
+	{
+		auto shoe = Shoe{{.decks = 1, .reshuffle = ReshufflePolicy::EveryRound}};
+		shoe.shuffle(rng);
+
+		WHEN("Any card has been dealt")
+		{
+			deal_from(shoe, 1);
+
+			THEN("It needs reshuffling")
+			{
+				CHECK(shoe.dealt() == 1);
+				CHECK(shoe.needs_reshuffle());
+			}
+		}
+	}
+
+	GIVEN("A shuffled six-deck shoe dealt to a cut card")
+	{
+		auto shoe = Shoe{{.decks = 6, .penetration = 0.5, .reshuffle = ReshufflePolicy::CutCard}};
+		shoe.shuffle(rng);
+
+		WHEN("Dealing up to just before the cut card")
+		{
+			deal_from(shoe, 155);
+
+			THEN("It does not need reshuffling")
+			{
+				CHECK_FALSE(shoe.needs_reshuffle());
+			}
+		}
+
+		WHEN("Dealing past the cut card")
+		{
+			deal_from(shoe, 156);
+
+			THEN("It needs reshuffling")
+			{
+				CHECK(shoe.needs_reshuffle());
+			}
+
+			AND_WHEN("Shuffling it")
+			{
+				shoe.shuffle(rng);
+
+				THEN("All cards are back in the shoe")
+				{
+					CHECK(shoe.dealt() == 0);
+					CHECK(shoe.deck().cards().size() == 312);
+				}
+			}
+		}
+	}
+}
+
+// ============================================================================
+// Games dealing from a shoe
+// ============================================================================
+
+SCENARIO("Games dealing from a shoe")
+{
+	const auto config = BlackjackConfig{
+		.seed = 3, .shoe = {.decks = 6, .penetration = 0.75, .reshuffle = ReshufflePolicy::CutCard}};
+
+	GIVEN("A game configured with a six-deck shoe")
+	{
+		auto game = Game{config};
+
+		THEN("It starts from the full shoe, to be shuffled when the round is dealt")
+		{
+			CHECK(game.shoe().dealt() == 0);
+			CHECK(game.shoe().needs_reshuffle());
+		}
+
+		WHEN("Dealing a round")
+		{
+			game.next(Game::Play::Deal);
+
+			THEN("The shoe is shuffled and reflects the dealt cards")
+			{
+				CHECK(game.state().deck().cards().size() == 308);
+				CHECK(game.shoe().dealt() == 4);
+				CHECK_FALSE(game.shoe().needs_reshuffle());
+			}
+
+			AND_WHEN("Continuing with the shoe in the next game")
+			{
+				const auto next_game = Game{config, game.shoe()};
+
+				THEN("The next game deals from where the last one stopped")
+				{
+					CHECK(next_game.state().deck() == game.state().deck());
+					CHECK(next_game.shoe().dealt() == 4);
+				}
+			}
+		}
+	}
+
+	GIVEN("A shoe past its cut card")
+	{
+		auto rng = Rng{8};
+		auto shoe = Shoe{config.shoe};
+		shoe.shuffle(rng);
+		deal_from(shoe, shoe.cut_card());
+
+		WHEN("Starting a game with it and dealing")
+		{
+			auto game = Game{config, shoe};
+			game.next(Game::Play::Deal);
+
+			THEN("The game reshuffles the shoe before dealing")
+			{
+				CHECK(game.shoe().dealt() == 4);
+				CHECK(game.state().deck().cards().size() == 308);
+			}
+		}
+	}
+
+	GIVEN("A default game")
+	{
+		auto game = Game{};
+
+		THEN("It deals from a single deck")
+		{
+			CHECK(game.shoe().config() == ShoeConfig{});
+			CHECK(game.next(Game::Play::Deal).deck().cards().size() == 48);
+		}
+	}
+
+	GIVEN("A single-deck game dealt from an initial deck of two decks")
+	{
+		auto game = Game{{.initial_deck = Shoe{{.decks = 2}}.deck()}};
+
+		WHEN("Dealing a round")
+		{
+			game.next(Game::Play::Deal);
+
+			THEN("Its shoe is left as it was, with none of its cards dealt")
+			{
+				CHECK(game.shoe() == Shoe{});
+				CHECK(game.shoe().dealt() == 0);
+				CHECK(game.shoe().needs_reshuffle());
+			}
+		}
+	}
+}
+
+// ============================================================================
+// Sessions of rounds
+// ============================================================================
+
+SCENARIO("Playing a session of rounds on one game")
+{
+	GIVEN("A game with a six-deck shoe after a round")
+	{
+		auto game = Game{{.seed = 4,
+											.shoe = {.decks = 6,
+															 .penetration = 0.75,
+															 .reshuffle = ReshufflePolicy::CutCard}}};
+		game.next(Game::Play::Deal);
+		while (game.state().node() == GameNode::PlayersRound)
+			game.next(Game::Play::Stay);
+		const auto remaining = game.state().deck();
+
+		WHEN("Starting a new round")
+		{
+			const auto& state = game.new_round();
+
+			THEN("It is ready to deal from the cards left in the shoe")
+			{
+				CHECK(state.node() == GameNode::Ready);
+				CHECK(state.players_hand().active_cards().empty());
+				CHECK(state.dealer_hand().cards().empty());
+				CHECK(state.deck() == remaining);
+				CHECK(game.shoe().dealt() == 312 - remaining.cards().size());
+			}
+
+			THEN("The next round deals as usual")
+			{
+				game.next(Game::Play::Deal);
+				CHECK(game.state().players_hand().active_cards().size() == 2);
+				CHECK(game.state().deck().cards().size() == remaining.cards().size() - 4);
+			}
+		}
+
+		WHEN("Starting new rounds until the cut card comes out")
+		{
+			auto reshuffled = false;
+			for (int round = 0; round < 100 && !reshuffled; ++round) {
+				game.new_round();
+				const auto dealt = game.shoe().dealt();
+				game.next(Game::Play::Deal);
+				reshuffled = game.shoe().dealt() < dealt;
+			}
+
+			THEN("The shoe is reshuffled and the round is dealt from all its cards")
+			{
+				REQUIRE(reshuffled);
+				CHECK(game.shoe().dealt() == 4);
+				CHECK(game.state().deck().cards().size() == 308);
+			}
+		}
+	}
+
+	GIVEN("A game dealt from an initial deck")
+	{
+		auto game = Game{{.initial_deck = Deck{}, .seed = 1}};
+		game.next(Game::Play::Deal);
+
+		WHEN("Starting a new round")
+		{
+			game.new_round();
+
+			THEN("The round deals from the initial deck again")
+			{
+				CHECK(game.state().node() == GameNode::Ready);
+				CHECK(game.state().deck() == Deck{});
+			}
+		}
+	}
+
+	GIVEN("Two games with the same seed")
+	{
+		const auto config = BlackjackConfig{.seed = 21};
+		auto a = Game{config};
+		auto b = Game{config};
+
+		THEN("Their sessions deal the same cards round after round")
+		{
+			for (int round = 0; round < 5; ++round) {
+				CHECK(a.next(Game::Play::Deal) == b.next(Game::Play::Deal));
+				CHECK(a.new_round() == b.new_round());
+			}
+		}
+	}
+}
+
+SCENARIO("A round started before the cut card is finished from the same shoe")
+{
+	GIVEN("Single-deck shoes dealt to the cut card, and a player who splits whatever they may "
+				"and hits below 21")
+	{
+		THEN("No round takes more cards than the shoe had left when it started")
+		{
+			for (const auto penetration : {0.75, 1.0}) {
+				auto game = Game{{.seed = 8,
+													.shoe = {.decks = 1,
+																	 .penetration = penetration,
+																	 .reshuffle = ReshufflePolicy::CutCard}}};
+				auto overdrawn_rounds = 0;
+				auto most_cards = std::size_t{0};
+				for (int round = 0; round < 20'000; ++round) {
+					game.new_round();
+					const auto* state = &game.next(Game::Play::Deal);
+					const auto left = state->deck().cards().size() + 4;
+					while (state->node() == GameNode::PlayersRound ||
+								 state->node() == GameNode::PlayersSplitRound) {
+						const auto split = state->legal_moves().contains(Play::Split);
+						const auto hit = state->players_hand().active_total() < 21;
+						state = &game.next(split ? Play::Split : hit ? Play::Hit : Play::Stay);
+					}
+
+					auto cards = state->dealer_hand().cards().size();
+					for (const auto& hand : state->players_hand().all_hands())
+						cards += hand.cards.size();
+					overdrawn_rounds += cards > left ? 1 : 0;
+					most_cards = std::max(most_cards, cards);
+				}
+				CHECK(overdrawn_rounds == 0);
+				CHECK(most_cards > 15);
+				CHECK(most_cards <= max_round_cards(1));
+			}
+		}
+	}
+}
+
+// ============================================================================
+// Rank composition
+// ============================================================================
+
+SCENARIO("A shoe counts the ranks left to deal")
+{
+	GIVEN("A shuffled six-deck shoe")
+	{
+		auto rng = Rng{13};
+		auto shoe = Shoe{{.decks = 6}};
+		shoe.shuffle(rng);
+
+		THEN("It holds 24 of each rank")
+		{
+			for (const auto rank : Card::ranks())
+				CHECK(shoe.composition().count(rank) == 24);
+			CHECK(shoe.composition().ten_valued() == 96);
+			CHECK(shoe.composition().total() == shoe.size());
+		}
+
+		WHEN("Part of it is dealt")
+		{
+			deal_from(shoe, 100);
+
+			THEN("The counts match a recount of what is left")
+			{
+				CHECK(shoe.composition() == RankCounts{shoe.deck().cards()});
+				CHECK(shoe.composition().total() == 212);
+			}
+		}
+	}
+
+	GIVEN("A session of rounds on a six-deck shoe")
+	{
+		auto game = Game{{.seed = 4, .shoe = {.decks = 6, .reshuffle = ReshufflePolicy::CutCard}}};
+
+		THEN("After every round the counts match the cards left in the shoe")
+		{
+			auto mismatches = 0;
+			for (int round = 0; round < 50; ++round) {
+				game.next(Game::Play::Deal);
+				while (game.state().node() == GameNode::PlayersRound)
+					game.next(Game::Play::Hit);
+				if (game.state().deck().composition() != RankCounts{game.state().deck().cards()})
+					++mismatches;
+				game.new_round();
+			}
+			CHECK(mismatches == 0);
+		}
+	}
+}
@@ -0,0 +1,255 @@
+#include <catch2/catch_test_macros.hpp>
+#include <simulation.h>
+#include <test-decks.h>
+
+#include <numeric>
+
+using namespace CardGames::BlackJack;
+
+// ============================================================================
+// Named strategies
+// ============================================================================
+
+SCENARIO("Looking up strategies by name")
+{
+	GIVEN("The list of strategy names")
+	{
+		const auto names = get_strategy_names();
+
+		THEN("Every listed name resolves to a strategy")
+		{
+			REQUIRE_FALSE(names.empty());
+			for (const auto& name : names) {
+				CHECK(get_strategy(name).has_value());
+			}
+		}
+	}
+
+	GIVEN("An unknown name")
+	{
+		THEN("No strategy is returned")
+		{
+			CHECK_FALSE(get_strategy("no-such-strategy").has_value());
+		}
+	}
+}
+
+// ============================================================================
+// Playing a single round
+// ============================================================================
+
+SCENARIO("Playing a round with an automatic strategy")
+{
+	GIVEN("The dealer_bust deck and the naive strategy")
+	{
+		// Player 10+8 (18) stays, dealer 10+6 (16) hits a 10 and busts
+		auto game = Game{{.initial_deck = get_test_deck("dealer_bust")}};
+		const auto strategy = *get_strategy("naive");
+
+		WHEN("Playing the round")
+		{
+			const auto node = play_round(game, strategy);
+
+			THEN("The round ends with the dealer busting")
+			{
+				CHECK(node == GameNode::GameOverDealerBusts);
+				CHECK(game.state().node() == GameNode::GameOverDealerBusts);
+			}
+		}
+	}
+
+	GIVEN("The player_bust deck and a strategy that always hits")
+	{
+		auto game = Game{{.initial_deck = get_test_deck("player_bust")}};
+		const auto strategy = Strategy{[](const GameState&) { return Game::Play::Hit; }};
+
+		WHEN("Playing the round")
+		{
+			const auto node = play_round(game, strategy);
+
+			THEN("The player busts")
+			{
+				CHECK(node == GameNode::GameOverPlayerBusts);
+			}
+		}
+	}
+
+	GIVEN("A strategy that only ever asks for plays the game rejects")
+	{
+		auto game = Game{{.initial_deck = get_test_deck("dealer_bust")}};
+		const auto strategy = Strategy{[](const GameState&) { return Game::Play::Deal; }};
+
+		WHEN("Playing the round")
+		{
+			const auto node = play_round(game, strategy);
+
+			THEN("The rejected play is played as Stay and the round still completes")
+			{
+				CHECK(node == GameNode::GameOverDealerBusts);
+			}
+		}
+	}
+}
+
+// ============================================================================
+// Simulating many rounds
+// ============================================================================
+
+SCENARIO("Simulating many rounds")
+{
+	GIVEN("The basic strategy")
+	{
+		const auto strategy = *get_strategy("basic");
+
+		WHEN("Simulating 1000 rounds")
+		{
+			const auto result = simulate(1000, strategy);
+
+			THEN("Every round is tallied under exactly one game-over node")
+			{
+				CHECK(result.rounds == 1000);
+				CHECK(std::accumulate(result.outcomes.begin(), result.outcomes.end(), std::uint64_t{0}) ==
+							1000);
+				CHECK(result.count(GameNode::Ready) == 0);
+				CHECK(result.count(GameNode::PlayersRound) == 0);
+				CHECK(result.count(GameNode::PlayersSplitRound) == 0);
+				CHECK(result.count(GameNode::DealersRound) == 0);
+			}
+		}
+	}
+
+	GIVEN("A fixed deck")
+	{
+		const auto config = BlackjackConfig{.initial_deck = get_test_deck("dealer_bust")};
+
+		WHEN("Simulating 10 rounds")
+		{
+			const auto result = simulate(10, *get_strategy("naive"), config);
+
+			THEN("Every round has the same outcome")
+			{
+				CHECK(result.count(GameNode::GameOverDealerBusts) == 10);
+			}
+		}
+	}
+}
+
+// ============================================================================
+// Game node names
+// ============================================================================
+
+SCENARIO("Game node names")
+{
+	THEN("Every node has a distinct name")
+	{
+		for (std::size_t i = 0; i < game_node_count; ++i) {
+			for (std::size_t j = i + 1; j < game_node_count; ++j) {
+				CHECK(game_node_name(static_cast<GameNode>(i)) !=
+							game_node_name(static_cast<GameNode>(j)));
+			}
+		}
+	}
+}
+
+// ============================================================================
+// Seeded multi-threaded simulation
+// ============================================================================
+
+SCENARIO("Seeded simulation is reproducible across thread counts")
+{
+	GIVEN("The basic strategy and a master seed")
+	{
+		const auto strategy = *get_strategy("basic");
+		const auto rounds = 3 * simulation_batch_size + 17;
+
+		WHEN("Simulating with one, two and five threads")
+		{
+			const auto one = simulate(rounds, strategy, {}, {.seed = 42, .threads = 1});
+			const auto two = simulate(rounds, strategy, {}, {.seed = 42, .threads = 2});
+			const auto five = simulate(rounds, strategy, {}, {.seed = 42, .threads = 5});
+
+			THEN("Every round is played exactly once")
+			{
+				CHECK(one.rounds == rounds);
+				CHECK(std::accumulate(one.outcomes.begin(), one.outcomes.end(), std::uint64_t{0}) ==
+							rounds);
+			}
+
+			THEN("The totals are identical")
+			{
+				CHECK(one == two);
+				CHECK(one == five);
+			}
+		}
+
+		WHEN("Simulating with a different seed")
+		{
+			const auto a = simulate(rounds, strategy, {}, {.seed = 42, .threads = 2});
+			const auto b = simulate(rounds, strategy, {}, {.seed = 43, .threads = 2});
+
+			THEN("The totals differ")
+			{
+				CHECK(a != b);
+			}
+		}
+	}
+
+	GIVEN("No rounds")
+	{
+		const auto result = simulate(0, *get_strategy("basic"), {}, {.seed = 1});
+
+		THEN("The result is empty")
+		{
+			CHECK(result == SimulationResult{});
+		}
+	}
+}
+
+SCENARIO("Merging simulation results")
+{
+	GIVEN("Two results")
+	{
+		auto a = SimulationResult{};
+		a.rounds = 3;
+		a.outcomes[static_cast<std::size_t>(GameNode::GameOverDraw)] = 3;
+		auto b = SimulationResult{};
+		b.rounds = 2;
+		b.outcomes[static_cast<std::size_t>(GameNode::GameOverDraw)] = 1;
+		b.outcomes[static_cast<std::size_t>(GameNode::GameOverPlayerWins)] = 1;
+
+		WHEN("Adding one to the other")
+		{
+			a += b;
+
+			THEN("Rounds and outcomes are summed")
+			{
+				CHECK(a.rounds == 5);
+				CHECK(a.count(GameNode::GameOverDraw) == 4);
+				CHECK(a.count(GameNode::GameOverPlayerWins) == 1);
+			}
+		}
+	}
+}
+
+SCENARIO("Seeded simulation with a multi-deck shoe")
+{
+	GIVEN("A six-deck shoe dealt to a cut card")
+	{
+		const auto config = BlackjackConfig{
+			.shoe = {.decks = 6, .penetration = 0.75, .reshuffle = ReshufflePolicy::CutCard}};
+		const auto rounds = 2 * simulation_batch_size + 5;
+
+		WHEN("Simulating with one and three threads")
+		{
+			const auto one = simulate(rounds, *get_strategy("basic"), config, {.seed = 9, .threads = 1});
+			const auto three =
+				simulate(rounds, *get_strategy("basic"), config, {.seed = 9, .threads = 3});
+
+			THEN("Every round is played and the totals are identical")
+			{
+				CHECK(one.rounds == rounds);
+				CHECK(one == three);
+			}
+		}
+	}
+}